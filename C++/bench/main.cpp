@@ -0,0 +1,318 @@
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <cstdlib>
+#include "utils.h"
+
+#include "../logger/Logger.hpp"
+
+using namespace std;
+
+/*
+ * Logger benchmarks
+ *
+ * Usage : logger_bench [iterations]
+ *
+ * Each case prints one JSON object per line on the standard output :
+ * {"name": "...", "ops": 100000, "ns_per_op": 812.3, "p50": 790, "p90": 850, "p99": 1300, "p999": 9000,
+ *  "max": 45000, "lines_per_sec": 1231000}
+ * Percentiles are in nanoseconds, measured call by call. Multi-threaded cases only report the throughput.
+ */
+
+/**
+ * Access to the internal stages of the logger
+ */
+class LoggerBench {
+public:
+    static std::string constructMessage(const std::string &message, const std::string &format,
+                                        const std::vector<size_t> &keys, const struct timespec &now) {
+        return Logger::global().constructMessage(message, "bench", "INFO", format, keys.data(), now, 42, nullptr,
+                                                 nullptr);
+    }
+
+    static std::vector<size_t> formatKeys(const std::string &format) {
+        return Logger::formatKeys(format);
+    }
+
+    static struct timespec now() {
+        return Logger::stampToTime(Logger::clockStamp());
+    }
+
+    template<typename... Ts>
+    static std::string stringify(Ts const &... vals) {
+        return Logger::stringify(vals...);
+    }
+
+    static void escape(std::string &out, const std::string &data, bool json) {
+        Logger::escape(out, data.data(), data.length(), json);
+    }
+
+    static void sanitize(std::string &t) {
+        Logger::sanitizeMessage(t);
+    }
+};
+
+/**
+ * Stream buffer which drops everything, so the console cases measure the logger and not the terminal
+ */
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+
+    streamsize xsputn(const char *, streamsize n) override {
+        return n;
+    }
+};
+
+/**
+ * Where the results are written, the standard output before it is dropped
+ */
+static ostream *results = nullptr;
+
+static int64_t nowNano() {
+    struct timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (int64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static int64_t percentile(const vector<int64_t> &sorted, double p) {
+    if (sorted.empty())
+        return 0;
+
+    size_t i = (size_t) (p * (double) (sorted.size() - 1));
+    return sorted[i];
+}
+
+static void report(const string &name, vector<int64_t> &samples, int64_t total) {
+    sort(samples.begin(), samples.end());
+    double ops = (double) samples.size();
+
+    *results << "{\"name\": \"" << name << "\", \"ops\": " << samples.size()
+         << ", \"ns_per_op\": " << (double) total / ops
+         << ", \"p50\": " << percentile(samples, 0.5)
+         << ", \"p90\": " << percentile(samples, 0.9)
+         << ", \"p99\": " << percentile(samples, 0.99)
+         << ", \"p999\": " << percentile(samples, 0.999)
+         << ", \"max\": " << samples.back()
+         << ", \"lines_per_sec\": " << (uint64_t) (ops * 1e9 / (double) total) << "}" << endl;
+}
+
+static void reportThroughput(const string &name, uint64_t ops, int64_t total) {
+    *results << "{\"name\": \"" << name << "\", \"ops\": " << ops
+         << ", \"ns_per_op\": " << (double) total / (double) ops
+         << ", \"lines_per_sec\": " << (uint64_t) ((double) ops * 1e9 / (double) total) << "}" << endl;
+}
+
+/**
+ * Time each call of f
+ */
+template<typename F>
+static void measure(const string &name, int iterations, F f) {
+    vector<int64_t> samples((size_t) iterations);
+
+    int64_t start = nowNano();
+    for (int i = 0; i < iterations; i++) {
+        int64_t before = nowNano();
+        f(i);
+        samples[(size_t) i] = nowNano() - before;
+    }
+    int64_t total = nowNano() - start;
+
+    report(name, samples, total);
+}
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+static void latency(int iterations) {
+    const LoggerFileMode modes[] = {BUFFERED_FILE, DIRECT_FILE};
+    const char *modeNames[] = {"buffered", "direct"};
+    const LoggerOption options[] = {FILE_ONLY, CONSOLE_ONLY, FILE_AND_CONSOLE};
+    const char *optionNames[] = {"file_only", "console_only", "file_and_console"};
+    const char *formatNames[] = {"default", "json", "long"};
+    const string longFormat = "%Y-%M-%D %H:%m:%S.%N [%n] [%t] [%i %I] [%T] {%X} %C";
+
+    for (int m = 0; m < 2; m++) {
+        for (int f = 0; f < 3; f++) {
+            Logger::global().setFileMode(modes[m]);
+            if (f == 2)
+                Logger::global().setFormats(longFormat, longFormat, longFormat);
+            Logger::global().setJsonFile(f == 1);
+            Logger::init();
+
+            for (int o = 0; o < 3; o++) {
+                LoggerOption option = options[o];
+                measure(string("latency/") + modeNames[m] + "/" + formatNames[f] + "/" + optionNames[o], iterations,
+                        [option](int i) {
+                            INFO_LOG(option, "Benchmark message ", i, " with a value ", 3.14);
+                        });
+            }
+
+            Logger::exit();
+            rmDir("logs");
+            Logger::global().setFormats(CONSOLE_FORMAT, FILE_FORMAT, ADDITIONAL_FORMAT);
+        }
+    }
+    Logger::global().setJsonFile(false);
+    Logger::global().setFileMode(BUFFERED_FILE);
+}
+
+static void throughput(int iterations) {
+    unsigned maxThreads = thread::hardware_concurrency();
+    if (maxThreads == 0)
+        maxThreads = 4;
+
+    const LoggerFileMode modes[] = {BUFFERED_FILE, DIRECT_FILE, SHARDED_FILE};
+    const char *modeNames[] = {"buffered", "direct", "sharded"};
+
+    for (int m = 0; m < 3; m++) {
+        for (unsigned n = 1; n <= maxThreads; n *= 2) {
+            Logger::global().setFileMode(modes[m]);
+            Logger::init();
+
+            int perThread = iterations / (int) n;
+            vector<thread> threads;
+            int64_t start = nowNano();
+            for (unsigned t = 0; t < n; t++) {
+                threads.emplace_back([perThread]() {
+                    for (int i = 0; i < perThread; i++) {
+                        INFO_LOG(FILE_ONLY, "Benchmark message ", i);
+                    }
+                });
+            }
+            for (auto &t: threads)
+                t.join();
+            int64_t total = nowNano() - start;
+
+            Logger::exit();
+            rmDir("logs");
+
+            reportThroughput(string("throughput/") + modeNames[m] + "/" + to_string(n) + "_threads",
+                             (uint64_t) perThread * n, total);
+        }
+    }
+    Logger::global().setFileMode(BUFFERED_FILE);
+}
+
+static void filtered(int iterations) {
+    Logger::init(FILE_AND_CONSOLE, {INFO});
+
+    measure("filtered/show_types", iterations, [](int i) {
+        DEBUG_LOG(CONSOLE_ONLY, "Filtered message ", i);
+    });
+    measure("filtered/every_n", iterations, [](int i) {
+        DEBUG_LOG_EVERY_N(CONSOLE_ONLY, 1000000000, "Filtered message ", i);
+    });
+    measure("filtered/sampled", iterations, [](int i) {
+        DEBUG_LOG_SAMPLED(CONSOLE_ONLY, 0, "Filtered message ", i);
+    });
+    measure("filtered/rate_limited", iterations, [](int i) {
+        DEBUG_LOG_LIMITED(CONSOLE_ONLY, 0.001, 1, "Filtered message ", i);
+    });
+
+    Logger::exit();
+    rmDir("logs");
+}
+
+static void stages(int iterations) {
+    const char *formats[] = {"%C", "[%T]\t%C", "[%n-%h-%t]\t[%T]\t%C", "[%d]\t[%n-%t]\t[%T]\t%C"};
+    const char *formatNames[] = {"content", "console", "file", "date"};
+
+    struct timespec now{};
+    clock_gettime(CLOCK_REALTIME, &now);
+    string message = "Benchmark message 42\n";
+    for (int f = 0; f < 4; f++) {
+        string format = formats[f];
+        vector<size_t> keys = LoggerBench::formatKeys(format);
+        measure(string("construct_message/") + formatNames[f], iterations, [&](int) {
+            LoggerBench::constructMessage(message, format, keys, now);
+        });
+    }
+
+    const LoggerClockSource sources[] = {REALTIME_CLOCK, COARSE_CLOCK, TSC_CLOCK};
+    const char *sourceNames[] = {"realtime", "coarse", "tsc"};
+    for (int c = 0; c < 3; c++) {
+        Logger::setClock(sources[c]);
+        measure(string("clock/") + sourceNames[c], iterations, [](int) {
+            LoggerBench::now();
+        });
+    }
+    Logger::setClock(REALTIME_CLOCK);
+
+    measure("stringify/string", iterations, [](int) {
+        LoggerBench::stringify("Benchmark message");
+    });
+    measure("stringify/mixed", iterations, [](int i) {
+        LoggerBench::stringify("Benchmark message ", i, " with a value ", 3.14);
+    });
+
+    // 256 bytes, without and with characters to escape
+    string clean;
+    while (clean.length() < 256)
+        clean += "Request served to the user 42 in 3.5 ms. ";
+    clean.resize(256);
+    string dirty = clean;
+    for (size_t i = 0; i < dirty.length(); i += 32)
+        dirty[i] = i % 64 == 0 ? '\n' : '"';
+    string out;
+    measure("escape/clean_text", iterations, [&](int) {
+        out.clear();
+        LoggerBench::escape(out, clean, false);
+    });
+    measure("escape/clean_json", iterations, [&](int) {
+        out.clear();
+        LoggerBench::escape(out, clean, true);
+    });
+    measure("escape/dirty_json", iterations, [&](int) {
+        out.clear();
+        LoggerBench::escape(out, dirty, true);
+    });
+
+    // 256 bytes of valid UTF-8, nothing to escape
+    string utf8;
+    while (utf8.length() < 240)
+        utf8 += "Requête servie à l'utilisateur 42 en 3,5 ms. ";
+    measure("escape/utf8_text", iterations, [&](int) {
+        out.clear();
+        LoggerBench::escape(out, utf8, false);
+    });
+    measure("escape/utf8_json", iterations, [&](int) {
+        out.clear();
+        LoggerBench::escape(out, utf8, true);
+    });
+    // Sanitized in place, a clean message is only scanned
+    measure("sanitize/utf8", iterations, [&](int) {
+        LoggerBench::sanitize(utf8);
+    });
+}
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 100000;
+    if (iterations <= 0)
+        iterations = 100000;
+
+    // Do not remove a logs directory which is not ours
+    struct stat buffer{};
+    if (stat("logs", &buffer) == 0) {
+        cerr << "A logs directory already exists, run the benchmarks elsewhere" << endl;
+        return 1;
+    }
+
+    // Console logs are dropped, the results are written on the original buffer
+    NullBuffer null;
+    ostream out(cout.rdbuf());
+    results = &out;
+    streambuf *original = cout.rdbuf(&null);
+
+    latency(iterations);
+    throughput(iterations);
+    filtered(iterations);
+    stages(iterations);
+
+    cout.rdbuf(original);
+
+    return 0;
+}
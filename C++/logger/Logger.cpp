@@ -1,18 +1,419 @@
 #include "Logger.hpp"
 
-bool Logger::isInitialized = false;
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <sys/inotify.h>
+#endif
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/uio.h>
+#include <poll.h>
+#else
+#include <malloc.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define LOGGER_HAS_TSC
+#endif
+
+// Constant initialized, a static object may log before the dynamic initialization of this file
+const char *LOG_PATH = "./logs";
+
+const char *PROJECT_NAME = "project";
+
+const char *const CONSOLE_FORMAT = "[%T]\t%C";
+
+const char *const FILE_FORMAT = "[%n-%h-%t]\t[%T]\t%C";
+
+const char *const ADDITIONAL_FORMAT = "[%n-%t]\t[%T]\t%C";
+
+LoggerClockSource Logger::clockSource = REALTIME_CLOCK;
+
+std::atomic<uint32_t> Logger::clockSequence(0);
+
+std::atomic<uint64_t> Logger::tscBase(0);
+
+std::atomic<int64_t> Logger::tscBaseNs(0);
+
+std::atomic<double> Logger::tscRate(1.0);
+
+std::atomic<uint64_t> Logger::tscResync(1000000000);
+
+std::atomic<bool> Logger::tscCalibrating(false);
+
+volatile std::sig_atomic_t Logger::flightRecorderRequested = 0;
+
+std::atomic<unsigned> Logger::nextShard(0);
+
+std::map<std::string, uint8_t> Logger::moduleTypes;
+
+pthread_mutex_t Logger::moduleMutex = PTHREAD_MUTEX_INITIALIZER;
+
+std::map<std::string, size_t> Logger::contextKeys;
+
+pthread_mutex_t Logger::contextKeyMutex = PTHREAD_MUTEX_INITIALIZER;
+
+std::vector<std::pair<std::string, bool>> Logger::siteRules;
+
+pthread_mutex_t Logger::siteMutex = PTHREAD_MUTEX_INITIALIZER;
+
+std::thread *Logger::siteControl = nullptr;
+
+int Logger::siteControlStop = -1;
+
+std::atomic<LoggerLimiter *> LoggerLimiter::head(nullptr);
+
+std::atomic<uint64_t> LoggerModuleSite::generation(1);
+
+std::atomic<LoggerSite *> LoggerSite::head(nullptr);
+
+thread_local unsigned LoggerSpan::openSpans = 0;
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+static int64_t monotonicNano() {
+    struct timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (int64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static int64_t realtimeNano() {
+    struct timespec now{};
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    return (int64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static inline uint64_t readTsc() {
+#ifdef LOGGER_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+LoggerLimiter::LoggerLimiter(const char *function, LoggerType type, LoggerOption option, double perSecond,
+                             unsigned burst)
+        : owner(nullptr), function(function), type(type), option(option),
+          interval(perSecond > 0 ? (int64_t) (1000000000 / perSecond) : 0),
+          tolerance(interval * (burst > 0 ? burst : 1)), summaryPeriod(interval > 0 ? interval : 1000000000),
+          tat(0), lastHash(0), lastSummary(monotonicNano()), repeated(0), dropped(0), next(nullptr) {
+    next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed));
+}
+
+bool LoggerLimiter::acquire() {
+    if (interval == 0)
+        return true;
+
+    int64_t now = monotonicNano();
+    int64_t current = tat.load(std::memory_order_relaxed);
+    for (;;) {
+        int64_t next = (current > now ? current : now) + interval;
+        if (next - now > tolerance) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (tat.compare_exchange_weak(current, next, std::memory_order_relaxed))
+            return true;
+    }
+}
+
+bool LoggerLimiter::isDuplicate(uint64_t hash) {
+    // Called after acquire(), a message which is not a duplicate is always written
+    bool duplicate = lastHash.exchange(hash, std::memory_order_relaxed) == hash;
+    if (duplicate)
+        repeated.fetch_add(1, std::memory_order_relaxed);
+
+    return duplicate;
+}
+
+bool LoggerLimiter::summaryDue() {
+    int64_t now = monotonicNano();
+    int64_t previous = lastSummary.load(std::memory_order_relaxed);
+
+    // Only the duplicate which moves lastSummary forward writes the count
+    return now - previous >= summaryPeriod &&
+           lastSummary.compare_exchange_strong(previous, now, std::memory_order_relaxed);
+}
+
+void LoggerLimiter::forget() {
+    lastHash.store(0, std::memory_order_relaxed);
+}
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+LoggerModuleSite::LoggerModuleSite(const char *module) : module(module), cached(0) {}
+
+uint64_t LoggerModuleSite::refresh() {
+    // Read before resolving, a change during the resolution leaves the cache stale
+    uint64_t g = generation.load(std::memory_order_acquire);
+    uint64_t c = g << 8 | Logger::moduleMask(module);
+    cached.store(c, std::memory_order_relaxed);
+
+    return c;
+}
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+static bool globMatch(const char *pattern, const char *text, const char *suffix = "") {
+    // Matches text followed by suffix without joining them, iterative, backtracks to the last '*' only
+    size_t length = strlen(text);
+    size_t total = length + strlen(suffix);
+    const char *star = nullptr;
+    size_t resume = 0;
+    size_t i = 0;
+    while (i < total) {
+        char c = i < length ? text[i] : suffix[i - length];
+        if (*pattern == '*') {
+            star = pattern++;
+            resume = i;
+        } else if (*pattern == '?' || *pattern == c) {
+            pattern++;
+            i++;
+        } else if (star != nullptr) {
+            pattern = star + 1;
+            i = ++resume;
+        } else
+            return false;
+    }
+    while (*pattern == '*')
+        pattern++;
+
+    return *pattern == '\0';
+}
+
+LoggerSite::LoggerSite(const char *function, const char *file, int line)
+        : function(function), file(file), line(line), enabled(true), next(nullptr) {
+    // Under the rules' mutex, so a rule added meanwhile is not missed
+    pthread_mutex_lock(&Logger::siteMutex);
+    for (const auto &rule: Logger::siteRules)
+        if (matches(rule.first))
+            enabled.store(rule.second, std::memory_order_relaxed);
+    next = head.load(std::memory_order_relaxed);
+    head.store(this, std::memory_order_release);
+    pthread_mutex_unlock(&Logger::siteMutex);
+}
+
+bool LoggerSite::matches(const std::string &pattern) const {
+    if (globMatch(pattern.c_str(), function))
+        return true;
+
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), ":%d", line);
+    return globMatch(pattern.c_str(), file, suffix);
+}
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+LoggerSpan::LoggerSpan(Logger &logger, LoggerOption option, const char *name, const char *function)
+        : logger(&logger), option(option), logged(true), name(name), function(function),
+          start(Logger::clockStamp()), depth(openSpans++) {
+}
+
+LoggerSpan::LoggerSpan(Logger &logger, const char *name, const char *function)
+        : logger(&logger), option(FILE_ONLY), logged(false), name(name), function(function),
+          start(Logger::clockStamp()), depth(openSpans++) {
+}
+
+LoggerSpan::~LoggerSpan() {
+    uint64_t end = Logger::clockStamp();
+    openSpans--;
+    logger->endSpan(*this, end);
+}
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+LoggerMutex::LoggerMutex()
+        : state(0), profiling(false), spinning(false), spinLimit(100),
+          acquisitions(0), contended(0), waitNs(0), maxWaitNs(0), holdNs(0), maxHoldNs(0), holdStart(0) {
+    for (auto &site: sites) {
+        site.hash.store(0, std::memory_order_relaxed);
+        site.ready.store(false, std::memory_order_relaxed);
+        site.name[0] = '\0';
+        site.waits.store(0, std::memory_order_relaxed);
+        site.waitNs.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LoggerMutex::lock(const char *site) {
+    int c = 0;
+    if (!state.compare_exchange_strong(c, 1, std::memory_order_acquire)) {
+        bool profiled = profiling.load(std::memory_order_relaxed);
+        int64_t start = profiled ? monotonicNano() : 0;
+        bool acquired = false;
+
+        if (spinning.load(std::memory_order_relaxed)) {
+            unsigned limit = spinLimit.load(std::memory_order_relaxed);
+            unsigned spins = 0;
+            while (spins < limit && !acquired) {
+                cpuRelax();
+                spins++;
+                c = 0;
+                acquired = state.load(std::memory_order_relaxed) == 0 &&
+                           state.compare_exchange_weak(c, 1, std::memory_order_acquire);
+            }
+            // Aim at twice the spins which were needed, shrink when spinning did not help
+            if (acquired)
+                limit += ((int) (spins * 2) - (int) limit) / 8;
+            else
+                limit -= limit / 8;
+            spinLimit.store(std::max(10u, std::min(limit, 10000u)), std::memory_order_relaxed);
+        }
+
+        if (!acquired) {
+            c = state.exchange(2, std::memory_order_acquire);
+            while (c != 0) {
+                wait(2);
+                c = state.exchange(2, std::memory_order_acquire);
+            }
+        }
+
+        contended.store(contended.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (profiled) {
+            uint64_t waited = (uint64_t) (monotonicNano() - start);
+            waitNs.store(waitNs.load(std::memory_order_relaxed) + waited, std::memory_order_relaxed);
+            if (waited > maxWaitNs.load(std::memory_order_relaxed))
+                maxWaitNs.store(waited, std::memory_order_relaxed);
+            recordSite(site, waited);
+        }
+    }
+
+    acquisitions.store(acquisitions.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    holdStart = profiling.load(std::memory_order_relaxed) ? monotonicNano() : 0;
+}
+
+void LoggerMutex::unlock() {
+    if (holdStart != 0) {
+        uint64_t held = (uint64_t) (monotonicNano() - holdStart);
+        holdNs.store(holdNs.load(std::memory_order_relaxed) + held, std::memory_order_relaxed);
+        if (held > maxHoldNs.load(std::memory_order_relaxed))
+            maxHoldNs.store(held, std::memory_order_relaxed);
+    }
+
+    if (state.fetch_sub(1, std::memory_order_release) != 1) {
+        state.store(0, std::memory_order_release);
+        wake();
+    }
+}
+
+void LoggerMutex::setProfiling(bool enabled) {
+    profiling.store(enabled, std::memory_order_relaxed);
+}
+
+void LoggerMutex::setSpinning(bool enabled) {
+    spinning.store(enabled, std::memory_order_relaxed);
+}
+
+LoggerLockStats LoggerMutex::stats() const {
+    LoggerLockStats res{};
+    res.acquisitions = acquisitions.load(std::memory_order_relaxed);
+    res.contended = contended.load(std::memory_order_relaxed);
+    res.waitNs = waitNs.load(std::memory_order_relaxed);
+    res.maxWaitNs = maxWaitNs.load(std::memory_order_relaxed);
+    res.holdNs = holdNs.load(std::memory_order_relaxed);
+    res.maxHoldNs = maxHoldNs.load(std::memory_order_relaxed);
+
+    for (const auto &site: sites) {
+        if (!site.ready.load(std::memory_order_acquire))
+            continue;
+        LoggerLockSite s;
+        s.site = site.name;
+        s.waits = site.waits.load(std::memory_order_relaxed);
+        s.waitNs = site.waitNs.load(std::memory_order_relaxed);
+        res.sites.push_back(s);
+    }
+    std::sort(res.sites.begin(), res.sites.end(), [](const LoggerLockSite &a, const LoggerLockSite &b) {
+        return a.waitNs > b.waitNs;
+    });
+
+    return res;
+}
+
+void LoggerMutex::wait(int expected) {
+#ifdef __linux__
+    syscall(SYS_futex, (int *) &state, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+    (void) expected;
+    std::this_thread::yield();
+#endif
+}
+
+void LoggerMutex::wake() {
+#ifdef __linux__
+    syscall(SYS_futex, (int *) &state, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+}
+
+void LoggerMutex::recordSite(const char *site, uint64_t waited) {
+    // FNV-1a, 0 marks a free entry
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char *p = site; *p != '\0'; p++)
+        hash = (hash ^ (unsigned char) *p) * 1099511628211ULL;
+    if (hash == 0)
+        hash = 1;
+
+    for (size_t i = 0; i < SITES; i++) {
+        Site &entry = sites[(hash + i) % SITES];
+        uint64_t current = entry.hash.load(std::memory_order_relaxed);
+        if (current == 0 && entry.hash.compare_exchange_strong(current, hash, std::memory_order_relaxed)) {
+            strncpy(entry.name, site, sizeof(entry.name) - 1);
+            entry.name[sizeof(entry.name) - 1] = '\0';
+            entry.ready.store(true, std::memory_order_release);
+            current = hash;
+        }
+        if (current == hash) {
+            entry.waits.fetch_add(1, std::memory_order_relaxed);
+            entry.waitNs.fetch_add(waited, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+size_t LoggerHistogram::bucketOf(uint64_t value) {
+    if (value < 8)
+        return (size_t) value;
+
+    // 8 linear buckets between two powers of two
+    int exponent = 63 - __builtin_clzll(value);
+    return (size_t) (exponent - 2) * 8 + (size_t) ((value >> (exponent - 3)) & 7);
+}
 
-std::ofstream Logger::file("");
+uint64_t LoggerHistogram::lowerBound(size_t bucket) {
+    if (bucket < 8)
+        return bucket;
 
-std::vector<std::ostream *> Logger::additionalStreams = std::vector<std::ostream *>();
+    size_t exponent = bucket / 8 + 2;
+    return (uint64_t) (8 + bucket % 8) << (exponent - 3);
+}
 
-int Logger::nbLog = 0;
+uint64_t LoggerHistogram::percentile(double p) const {
+    if (count == 0)
+        return 0;
 
-pthread_mutex_t Logger::mutex;
+    uint64_t rank = (uint64_t) (p * (double) (count - 1));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen > rank)
+            return lowerBound(i);
+    }
 
-LoggerOption Logger::verbose = FILE_AND_CONSOLE;
+    return lowerBound(buckets.size() - 1);
+}
 
-std::vector <LoggerType> Logger::showTypes = {INFO, SUCCESS, ERROR, WARNING, DEBUG};
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
 
 
 std::string Logger::getColor(LoggerColor color) {
@@ -95,179 +496,2207 @@ std::string Logger::getTypeName(LoggerType type) {
     }
 }
 
+Logger::Logger(const std::string &projectName, const std::string &logPath)
+        : isInitialized(false), config(compileFormats(new LoggerConfig{
+                CONSOLE_FORMAT, FILE_FORMAT, ADDITIONAL_FORMAT, logPath, projectName, false, false, false, {}, {}, {}})),
+          configEpoch(0), configStop(-1), fileMode(BUFFERED_FILE), fileDescriptor(-1), fileOffset(0), indexDescriptor(-1),
+          indexInterval(0), nextIndexOffset(0), lastIndexTime(0), fileShards(nullptr), fileShardCount(SHARDS), syncDescriptor(-1),
+          durability{NO_SYNC, NO_SYNC, NO_SYNC, NO_SYNC, NO_SYNC}, syncPeriod(1000000000), lastSync(0),
+          writtenCount(0), syncedCount(0), syncing(false), nbLog(0), tracing(false), tracePid(0),
+          histogramsEnabled(false),
+          verbose(FILE_AND_CONSOLE), showTypes({INFO, SUCCESS, ERROR, WARNING, DEBUG}), flightRecorder(nullptr),
+          flightRecorderSeen(flightRecorderRequested) {
+    pthread_mutex_init(&syncMutex, nullptr);
+    pthread_cond_init(&syncCondition, nullptr);
+    pthread_mutex_init(&configMutex, nullptr);
+    pthread_mutex_init(&traceMutex, nullptr);
+    pthread_mutex_init(&indexMutex, nullptr);
+
+    for (auto &shard: shards) {
+        for (auto &messages: shard.messages)
+            messages.store(0, std::memory_order_relaxed);
+        shard.fileBytes.store(0, std::memory_order_relaxed);
+        shard.consoleBytes.store(0, std::memory_order_relaxed);
+        shard.streamBytes.store(0, std::memory_order_relaxed);
+        shard.dropped.store(0, std::memory_order_relaxed);
+        shard.suppressed.store(0, std::memory_order_relaxed);
+        shard.recorded.store(0, std::memory_order_relaxed);
+        shard.recorderHighWater.store(0, std::memory_order_relaxed);
+        shard.flushes.store(0, std::memory_order_relaxed);
+        shard.syncs.store(0, std::memory_order_relaxed);
+        shard.writeErrors.store(0, std::memory_order_relaxed);
+        for (int epoch = 0; epoch < 2; epoch++) {
+            shard.configEnter[epoch].store(0, std::memory_order_relaxed);
+            shard.configExit[epoch].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+Logger::~Logger() {
+    unwatchConfig();
+    if (isInitialized)
+        close();
+    closeTrace();
+
+    // A limiter used after close() still points to this logger
+    for (LoggerLimiter *limiter = LoggerLimiter::head.load(std::memory_order_acquire);
+         limiter != nullptr; limiter = limiter->next) {
+        Logger *owner = this;
+        limiter->owner.compare_exchange_strong(owner, nullptr, std::memory_order_acq_rel);
+    }
+
+    delete config.load(std::memory_order_relaxed);
+    delete flightRecorder.load(std::memory_order_relaxed);
+    pthread_mutex_destroy(&configMutex);
+    pthread_mutex_destroy(&traceMutex);
+    pthread_mutex_destroy(&indexMutex);
+    pthread_cond_destroy(&syncCondition);
+    pthread_mutex_destroy(&syncMutex);
+}
+
+void *Logger::operator new(size_t size) {
+#ifdef _WIN32
+    void *pointer = _aligned_malloc(size, alignof(Logger));
+
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+#else
+    void *pointer = nullptr;
+
+    if (posix_memalign(&pointer, alignof(Logger), size) != 0)
+        throw std::bad_alloc();
+#endif
+    return pointer;
+}
+
+void Logger::operator delete(void *pointer) noexcept {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    free(pointer);
+#endif
+}
+
+Logger &Logger::global() {
+    // Built in place and never destroyed, static objects may log from their destructors
+    static std::aligned_storage<sizeof(Logger), alignof(Logger)>::type storage;
+    static Logger *instance = new(&storage) Logger();
+
+    return *instance;
+}
+
 void Logger::init(LoggerOption verboseP, const std::vector <LoggerType> &showTypesP) {
+    global().open(verboseP, showTypesP);
+}
+
+void Logger::exit() {
+    global().close();
+}
+
+void Logger::addOutputStream(std::ostream *os) {
+    global().addStream(os);
+}
+
+void Logger::open(LoggerOption verboseP, const std::vector <LoggerType> &showTypesP) {
     if (!isInitialized) {
         verbose = verboseP;
         showTypes = showTypesP;
 
         bool dirCreated = false;
 
-        if (!file.is_open()) {
+        if (!isFileOpen()) {
+            LoggerConfig c = getConfig();
 #ifdef _WIN32
-            if (mkdir(LOG_PATH.c_str()) == 0)
+            if (mkdir(c.logPath.c_str()) == 0)
 #else
-            if (mkdir(LOG_PATH.c_str(), S_IRWXU) == 0)
+            if (mkdir(c.logPath.c_str(), S_IRWXU) == 0)
 #endif
                 dirCreated = true;
 
-            std::string fileName = (LOG_PATH + "/" + PROJECT_NAME + "_log_") + getDate() + ".log";
-            file.open(fileName, std::ios::out);
+            struct timespec now{};
+            clock_gettime(CLOCK_REALTIME, &now);
+            std::string fileName = (c.logPath + "/" + c.projectName + "_log_") + getDate(now) + ".log";
+            openFile(fileName);
         }
 
         nbLog = 0;
+        if (clockSource == TSC_CLOCK)
+            calibrateClock(true);
 
-        if (pthread_mutex_init(&mutex, nullptr) != 0)
-            ERROR_LOG(CONSOLE_ONLY, "Error mutex : %d\n", errno);
-
-        INFO_LOG(FILE_ONLY, "Log start\n");
+        info(__FUNCTION__, FILE_ONLY, "Log start\n");
         isInitialized = true;
         if (dirCreated)
-            WARNING_LOG(FILE_AND_CONSOLE, "Log directory created\n");
+            warning(__FUNCTION__, FILE_AND_CONSOLE, "Log directory created\n");
     } else
-        WARNING_LOG(FILE_AND_CONSOLE, "Log already init\n");
+        warning(__FUNCTION__, FILE_AND_CONSOLE, "Log already init\n");
 }
 
-void Logger::exit() {
+void Logger::close() {
     if (isInitialized) {
-        INFO_LOG(FILE_ONLY, "End log\n");
-        isInitialized = false;
+        for (LoggerLimiter *limiter = LoggerLimiter::head.load(std::memory_order_acquire);
+             limiter != nullptr; limiter = limiter->next) {
+            Logger *owner = this;
+            if (limiter->owner.load(std::memory_order_acquire) != this)
+                continue;
+            flushLimiter(*limiter);
+            limiter->forget();
+            limiter->owner.compare_exchange_strong(owner, nullptr, std::memory_order_acq_rel);
+        }
+        int requested = flightRecorderRequested;
+        if (flightRecorderSeen.exchange(requested, std::memory_order_relaxed) != requested)
+            dumpFlightRecorder();
 
-        if (file.is_open())
-            file.close();
+        info(__FUNCTION__, FILE_ONLY, "End log\n");
+        isInitialized = false;
 
-        pthread_mutex_destroy(&mutex);
+        closeFile();
     } else
-        ERROR_LOG(CONSOLE_ONLY, "Please init before exit\n");
+        error(__FUNCTION__, CONSOLE_ONLY, "Please init before exit\n");
 }
 
-void Logger::addOutputStream(std::ostream *os) {
+void Logger::addStream(std::ostream *os) {
     additionalStreams.push_back(os);
 }
 
-void Logger::genericLog(const std::string &function, const std::string &message, LoggerType type, LoggerOption option) {
-    std::string t = message;
+bool Logger::openTrace(const std::string &path) {
+    closeTrace();
 
-    if (t[t.length() - 1] != '\n') {
-        t += "\n";
+    pthread_mutex_lock(&traceMutex);
+    traceFile.open(path, std::ios::out | std::ios::trunc);
+    bool opened = traceFile.is_open();
+    if (opened) {
+        tracePid = (int) getpid();
+        // The process is named after the logger in the viewer, each event follows a ','
+        traceFile << "[{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << tracePid
+                  << ",\"args\":{\"name\":";
+        std::string name;
+        LoggerConfig c = getConfig();
+        appendJsonString(name, c.projectName.data(), c.projectName.length());
+        traceFile << name << "}}";
+        tracing.store(true, std::memory_order_release);
     }
+    pthread_mutex_unlock(&traceMutex);
 
-    if (option != FILE_ONLY && verbose != FILE_ONLY &&
-        std::find(showTypes.begin(), showTypes.end(), type) != showTypes.end())
-        std::cout << getTypeColor(type) << constructMessage(t, function, getTypeName(type), CONSOLE_FORMAT)
-                  << getColor(DEFAULT);
-
-    if (option != CONSOLE_ONLY && verbose != CONSOLE_ONLY) {
-        pthread_mutex_lock(&mutex);
-        writeToFile(constructMessage(t, function, getTypeName(type), FILE_FORMAT));
-        pthread_mutex_unlock(&mutex);
-    }
+    return opened;
+}
 
-    if (option != CONSOLE_ONLY && option != FILE_ONLY && verbose == FILE_AND_CONSOLE) {
-        for (const auto &os: additionalStreams) {
-            std::string m = constructMessage(t, function, getTypeName(type), ADDITIONAL_FORMAT);
-            os->write(m.c_str(), (long) m.length());
-            os->flush();
-        }
+void Logger::closeTrace() {
+    pthread_mutex_lock(&traceMutex);
+    if (tracing.load(std::memory_order_relaxed)) {
+        tracing.store(false, std::memory_order_relaxed);
+        traceFile << "\n]\n";
+        traceFile.close();
     }
-
-    nbLog++;
+    pthread_mutex_unlock(&traceMutex);
 }
 
-std::string Logger::constructMessage(const std::string &message, const std::string &trace, const std::string &logType,
-                                     const std::string &format) {
-    std::string res;
+void Logger::endSpan(const LoggerSpan &span, uint64_t end) {
+    if (!span.logged && !tracing.load(std::memory_order_acquire))
+        return;
 
-    int i = 0;
-    while (i < format.length()) {
-        char c = format[i];
-        if (c == '%') {
-            i++;
-            c = format[i];
+    struct timespec from = stampToTime(span.start);
+    struct timespec to = stampToTime(end);
+    int64_t begin = (int64_t) from.tv_sec * 1000000000 + from.tv_nsec;
+    int64_t duration = (int64_t) to.tv_sec * 1000000000 + to.tv_nsec - begin;
+    if (duration < 0)
+        duration = 0;
 
-            struct timespec now{};
-            clock_gettime(CLOCK_REALTIME, &now);
-            struct tm *t = localtime(&now.tv_sec);
-            switch (c) {
-                case 'Y':
-                    res += std::to_string(t->tm_year + 1900);
-                    break;
-                case 'M':
-                    res += std::to_string(t->tm_mon + 1);
-                    break;
-                case 'D':
-                    res += std::to_string(t->tm_mday);
-                    break;
-                case 'H':
-                    res += std::to_string(t->tm_hour);
-                    break;
-                case 'm':
-                    res += std::to_string(t->tm_min);
-                    break;
-                case 'S':
-                    res += std::to_string(t->tm_sec);
-                    break;
-                case 'N':
-                    res += std::to_string(now.tv_nsec);
-                    break;
-                case 'd':
-                    res += getDate();
-                    break;
-                case 'h':
-                    res += getHour();
-                    break;
-                case 'T':
-                    res += trace;
-                    break;
-                case 'C':
-                    res += message;
-                    break;
-                case 'n':
-                    res += std::to_string(nbLog);
-                    break;
-                case 't':
-                    res += logType;
-                    break;
-                default:
-                    break;
-            }
-        } else {
-            res += c;
-        }
+    char text[32];
+    snprintf(text, sizeof(text), "%lld.%03d", (long long) (duration / 1000), (int) (duration % 1000));
 
-        i++;
+    if (tracing.load(std::memory_order_acquire)) {
+        // Microseconds, with the nanoseconds as decimals
+        char event[160];
+        int n = snprintf(event, sizeof(event),
+                         ",\"ph\":\"X\",\"ts\":%lld.%03d,\"dur\":%s,\"pid\":%d,\"tid\":%llu,\"args\":{\"depth\":%u,"
+                         "\"trace\":", (long long) (begin / 1000), (int) (begin % 1000), text, tracePid,
+                         (unsigned long long) threadId(), span.depth);
+        // Reused by the thread, no allocation once it is large enough
+        static thread_local std::string line;
+        line = ",\n{\"name\":";
+        appendJsonString(line, span.name, strlen(span.name));
+        line.append(event, (size_t) n);
+        appendJsonString(line, span.function, strlen(span.function));
+        line += "}}";
+
+        pthread_mutex_lock(&traceMutex);
+        if (tracing.load(std::memory_order_relaxed))
+            traceFile << line;
+        pthread_mutex_unlock(&traceMutex);
     }
 
-    return res;
+    if (span.logged)
+        genericLog(span.function, stringify(span.name, " took ", text, " us\n"), DEBUG, span.option);
 }
 
-void Logger::writeToFile(const std::string &message) {
-    if (file.is_open()) {
-        file << message;
-        file.flush();
-    } else if (!isInitialized)
-        ERROR_LOG(CONSOLE_ONLY, "Please init logger\n");
+uint64_t Logger::threadId() {
+#ifdef __linux__
+    static thread_local uint64_t id = (uint64_t) syscall(SYS_gettid);
+#else
+    static thread_local uint64_t id = std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+
+    return id;
 }
 
-std::string Logger::getHour() {
-    struct timespec now{};
-    clock_gettime(CLOCK_REALTIME, &now);
-    struct tm *t = localtime(&now.tv_sec);
+void Logger::setFormats(const std::string &consoleFormat, const std::string &fileFormat,
+                        const std::string &additionalFormat) {
+    auto *next = new LoggerConfig(getConfig());
+    next->consoleFormat = consoleFormat;
+    next->fileFormat = fileFormat;
+    next->additionalFormat = additionalFormat;
+    publishConfig(next);
+}
 
-    return std::to_string(t->tm_hour) + ":"
-           + std::to_string(t->tm_min) + ":"
-           + std::to_string(t->tm_sec) + ":"
+void Logger::setJsonFile(bool enabled) {
+    auto *next = new LoggerConfig(getConfig());
+    next->jsonFile = enabled;
+    publishConfig(next);
+}
+
+void Logger::setSanitize(bool enabled) {
+    auto *next = new LoggerConfig(getConfig());
+    next->sanitize = enabled;
+    publishConfig(next);
+}
+
+void Logger::setMultiline(bool enabled) {
+    auto *next = new LoggerConfig(getConfig());
+    next->multiline = enabled;
+    publishConfig(next);
+}
+
+void Logger::setContext(const std::string &key, const std::string &value) {
+    std::shared_ptr<const Context> &current = threadContext();
+    std::shared_ptr<Context> next = current ? std::make_shared<Context>(*current) : std::make_shared<Context>();
+    bool found = false;
+    for (auto &field: next->fields) {
+        if (field.first == key) {
+            field.second = value;
+            found = true;
+            break;
+        }
+    }
+    if (!found)
+        next->fields.emplace_back(key, value);
+    renderContext(*next);
+    current = next;
+}
+
+void Logger::removeContext(const std::string &key) {
+    std::shared_ptr<const Context> &current = threadContext();
+    if (!current)
+        return;
+
+    std::shared_ptr<Context> next = std::make_shared<Context>(*current);
+    next->fields.erase(std::remove_if(next->fields.begin(), next->fields.end(),
+                                      [&key](const std::pair<std::string, std::string> &field) {
+                                          return field.first == key;
+                                      }), next->fields.end());
+    if (next->fields.empty()) {
+        current.reset();
+        return;
+    }
+    renderContext(*next);
+    current = next;
+}
+
+void Logger::clearContext() {
+    threadContext().reset();
+}
+
+std::shared_ptr<const Logger::Context> &Logger::threadContext() {
+    // Replaced, never modified, so a recorded log keeps the context it had
+    static thread_local std::shared_ptr<const Context> context;
+    return context;
+}
+
+std::string &Logger::captureBuffer() {
+    static thread_local std::string buffer;
+    return buffer;
+}
+
+Logger::Thread &Logger::currentThread() {
+    static thread_local Thread thread;
+    if (thread.id.empty()) {
+        thread.id = std::to_string(threadId());
+#ifndef _WIN32
+        char name[64];
+        if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0)
+            thread.name = name;
+#endif
+        if (thread.name.empty())
+            thread.name = thread.id;
+    }
+
+    return thread;
+}
+
+void Logger::setThreadName(const std::string &name) {
+#if defined(__linux__)
+    // At most 15 characters for Linux
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#elif defined(__APPLE__)
+    pthread_setname_np(name.c_str());
+#endif
+    currentThread().name = name;
+}
+
+void Logger::renderContext(Context &context) {
+    context.text.clear();
+    context.json.clear();
+    context.values.clear();
+    for (const auto &field: context.fields) {
+        size_t id = contextKeyId(field.first);
+        if (id >= context.values.size())
+            context.values.resize(id + 1);
+        context.values[id] = field.second;
+
+        if (!context.text.empty())
+            context.text += ' ';
+        context.text += field.first;
+        context.text += '=';
+        context.text += field.second;
+
+        context.json += ',';
+        appendJsonString(context.json, field.first.data(), field.first.length());
+        context.json += ':';
+        appendJsonString(context.json, field.second.data(), field.second.length());
+    }
+}
+
+size_t Logger::contextKeyId(const std::string &key) {
+    pthread_mutex_lock(&contextKeyMutex);
+    size_t id = contextKeys.emplace(key, contextKeys.size()).first->second;
+    pthread_mutex_unlock(&contextKeyMutex);
+
+    return id;
+}
+
+bool Logger::nextFormatKey(const std::string &format, size_t &from, std::string &key) {
+    size_t i = from;
+    while (i < format.length()) {
+        if (format[i] == '%') {
+            i++;
+            if (i + 1 < format.length() && format[i] == 'X' && format[i + 1] == '{') {
+                size_t end = format.find('}', i + 2);
+                if (end == std::string::npos)
+                    end = format.length();
+                key = format.substr(i + 2, end - (i + 2));
+                from = end + 1;
+                return true;
+            }
+        }
+
+        i++;
+    }
+
+    from = i;
+    return false;
+}
+
+std::vector<size_t> Logger::formatKeys(const std::string &format) {
+    std::vector<size_t> res;
+    size_t from = 0;
+    std::string key;
+    while (nextFormatKey(format, from, key))
+        res.push_back(contextKeyId(key));
+
+    return res;
+}
+
+LoggerConfig *Logger::compileFormats(LoggerConfig *configuration) {
+    configuration->consoleKeys = formatKeys(configuration->consoleFormat);
+    configuration->fileKeys = formatKeys(configuration->fileFormat);
+    configuration->additionalKeys = formatKeys(configuration->additionalFormat);
+
+    return configuration;
+}
+
+LoggerConfig Logger::getConfig() {
+    unsigned epoch;
+    LoggerConfig res = *acquireConfig(epoch);
+    releaseConfig(epoch);
+
+    return res;
+}
+
+bool Logger::loadConfig(const std::string &path) {
+    std::ifstream in(path);
+    if (!in.is_open())
+        return false;
+
+    auto *next = new LoggerConfig(getConfig());
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.resize(comment);
+        size_t equal = line.find('=');
+        if (equal == std::string::npos)
+            continue;
+
+        std::string key = line.substr(0, equal);
+        key.erase(key.find_last_not_of(" \t\r") + 1);
+        key.erase(0, key.find_first_not_of(" \t"));
+        std::string raw = line.substr(equal + 1);
+        raw.erase(raw.find_last_not_of(" \t\r") + 1);
+        raw.erase(0, raw.find_first_not_of(" \t"));
+
+        std::string value;
+        for (size_t i = 0; i < raw.length(); i++) {
+            if (raw[i] == '\\' && i + 1 < raw.length()) {
+                i++;
+                value += raw[i] == 't' ? '\t' : raw[i] == 'n' ? '\n' : raw[i];
+            } else
+                value += raw[i];
+        }
+
+        if (key == "console_format")
+            next->consoleFormat = value;
+        else if (key == "file_format")
+            next->fileFormat = value;
+        else if (key == "additional_format")
+            next->additionalFormat = value;
+        else if (key == "log_path")
+            next->logPath = value;
+        else if (key == "project_name")
+            next->projectName = value;
+        else if (key == "json_file")
+            next->jsonFile = value == "true";
+        else if (key == "sanitize")
+            next->sanitize = value == "true";
+        else if (key == "multiline")
+            next->multiline = value == "true";
+        else
+            warning(__FUNCTION__, FILE_AND_CONSOLE, "Unknown configuration key '", key, "' in ", path, "\n");
+    }
+
+    publishConfig(next);
+
+    return true;
+}
+
+void Logger::watchConfig(const std::string &path) {
+    unwatchConfig();
+    loadConfig(path);
+
+#ifdef __linux__
+    // Watch the directory, editors replace the file instead of writing it
+    size_t slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+
+    int watch = inotify_init1(IN_CLOEXEC);
+    if (watch < 0)
+        return;
+    int stop[2];
+    if (inotify_add_watch(watch, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0 || pipe(stop) != 0) {
+        ::close(watch);
+        return;
+    }
+    configStop = stop[1];
+
+    configWatcher = std::thread([this, watch, stop, path, name]() {
+        alignas(struct inotify_event) char buffer[4096];
+        for (;;) {
+            struct pollfd fds[2] = {{watch, POLLIN, 0}, {stop[0], POLLIN, 0}};
+            if (poll(fds, 2, -1) < 0 && errno != EINTR)
+                break;
+            if (fds[1].revents != 0)
+                break;
+            if ((fds[0].revents & POLLIN) == 0)
+                continue;
+
+            ssize_t n = read(watch, buffer, sizeof(buffer));
+            bool changed = false;
+            for (ssize_t i = 0; i < n;) {
+                auto *event = (struct inotify_event *) (buffer + i);
+                if (event->len > 0 && name == event->name)
+                    changed = true;
+                i += (ssize_t) (sizeof(struct inotify_event) + event->len);
+            }
+            if (changed)
+                loadConfig(path);
+        }
+        ::close(watch);
+        ::close(stop[0]);
+    });
+#endif
+}
+
+void Logger::unwatchConfig() {
+    if (configStop >= 0) {
+        char c = 0;
+        if (write(configStop, &c, 1) < 0)
+            error(__FUNCTION__, CONSOLE_ONLY, "Cannot stop the configuration watcher\n");
+        if (configWatcher.joinable())
+            configWatcher.join();
+        ::close(configStop);
+        configStop = -1;
+    }
+}
+
+void Logger::publishConfig(LoggerConfig *next) {
+    compileFormats(next);
+    pthread_mutex_lock(&configMutex);
+    const LoggerConfig *previous = config.exchange(next, std::memory_order_seq_cst);
+    waitForReaders();
+    delete previous;
+    pthread_mutex_unlock(&configMutex);
+}
+
+void Logger::publishFlightRecorder(FlightRecorder *next) {
+    pthread_mutex_lock(&configMutex);
+    FlightRecorder *previous = flightRecorder.exchange(next, std::memory_order_seq_cst);
+    waitForReaders();
+    delete previous;
+    pthread_mutex_unlock(&configMutex);
+}
+
+void Logger::waitForReaders() {
+    // A log which did not see the new pointer has entered its shard before the exchange, on either index :
+    // the inactive one holds the logs which read the index just before the previous flip.
+    // Once it is drained, new logs go to the other index and only the logs already inside are waited for
+    unsigned active = configEpoch.load(std::memory_order_relaxed) & 1;
+    drainReaders(active ^ 1);
+    configEpoch.store(active ^ 1, std::memory_order_seq_cst);
+    drainReaders(active);
+}
+
+void Logger::drainReaders(unsigned epoch) {
+    for (auto &shard: shards) {
+        for (;;) {
+            uint64_t exited = shard.configExit[epoch].load(std::memory_order_seq_cst);
+            if (shard.configEnter[epoch].load(std::memory_order_seq_cst) == exited)
+                break;
+            std::this_thread::yield();
+        }
+    }
+}
+
+LoggerStats Logger::stats() const {
+    LoggerStats res{};
+
+    for (const auto &shard: shards) {
+        for (int type = 0; type <= DEBUG; type++)
+            res.messages[type] += shard.messages[type].load(std::memory_order_relaxed);
+        res.fileBytes += shard.fileBytes.load(std::memory_order_relaxed);
+        res.consoleBytes += shard.consoleBytes.load(std::memory_order_relaxed);
+        res.streamBytes += shard.streamBytes.load(std::memory_order_relaxed);
+        res.dropped += shard.dropped.load(std::memory_order_relaxed);
+        res.suppressed += shard.suppressed.load(std::memory_order_relaxed);
+        res.recorded += shard.recorded.load(std::memory_order_relaxed);
+        res.recorderHighWater = std::max(res.recorderHighWater,
+                                         shard.recorderHighWater.load(std::memory_order_relaxed));
+        res.flushes += shard.flushes.load(std::memory_order_relaxed);
+        res.syncs += shard.syncs.load(std::memory_order_relaxed);
+        res.writeErrors += shard.writeErrors.load(std::memory_order_relaxed);
+    }
+
+    return res;
+}
+
+void Logger::setLockProfiling(bool enabled) {
+    mutex.setProfiling(enabled);
+}
+
+void Logger::setLockSpinning(bool enabled) {
+    mutex.setSpinning(enabled);
+}
+
+LoggerLockStats Logger::lockStats() const {
+    return mutex.stats();
+}
+
+void Logger::exportLockProfile(std::ostream &os, size_t top) const {
+    LoggerLockStats s = mutex.stats();
+
+    os << "{\"acquisitions\": " << s.acquisitions << ", \"contended\": " << s.contended
+       << ", \"wait_ns\": " << s.waitNs << ", \"max_wait_ns\": " << s.maxWaitNs
+       << ", \"hold_ns\": " << s.holdNs << ", \"max_hold_ns\": " << s.maxHoldNs << ", \"sites\": [";
+    for (size_t i = 0; i < s.sites.size() && i < top; i++) {
+        os << (i == 0 ? "" : ", ") << "{\"site\": \"" << s.sites[i].site << "\", \"waits\": " << s.sites[i].waits
+           << ", \"wait_ns\": " << s.sites[i].waitNs << "}";
+    }
+    os << "]}" << std::endl;
+}
+
+void Logger::enableHistograms() {
+    if (!histogramShards) {
+        histogramShards.reset(new Histograms[HISTOGRAM_SHARDS]);
+        for (unsigned i = 0; i < HISTOGRAM_SHARDS; i++)
+            for (auto &stage: histogramShards[i].buckets)
+                for (auto &bucket: stage)
+                    bucket.store(0, std::memory_order_relaxed);
+    }
+    histogramsEnabled.store(true, std::memory_order_release);
+}
+
+void Logger::disableHistograms() {
+    histogramsEnabled.store(false, std::memory_order_relaxed);
+}
+
+std::vector<LoggerHistogram> Logger::histograms() const {
+    std::vector<LoggerHistogram> res;
+
+    for (int stage = 0; stage <= SYNC_STAGE; stage++) {
+        LoggerHistogram h;
+        h.stage = (LoggerStage) stage;
+        h.count = 0;
+        h.buckets.assign(LoggerHistogram::BUCKETS, 0);
+        if (histogramShards) {
+            for (unsigned i = 0; i < HISTOGRAM_SHARDS; i++) {
+                for (size_t b = 0; b < LoggerHistogram::BUCKETS; b++) {
+                    uint64_t n = histogramShards[i].buckets[stage][b].load(std::memory_order_relaxed);
+                    h.buckets[b] += n;
+                    h.count += n;
+                }
+            }
+        }
+        res.push_back(h);
+    }
+
+    return res;
+}
+
+void Logger::exportHistograms(std::ostream &os) const {
+    for (const auto &h: histograms()) {
+        size_t last = 0;
+        for (size_t b = 0; b < h.buckets.size(); b++)
+            if (h.buckets[b] > 0)
+                last = b;
+
+        os << "{\"stage\": \"" << getStageName(h.stage) << "\", \"count\": " << h.count
+           << ", \"p50\": " << h.percentile(0.5)
+           << ", \"p90\": " << h.percentile(0.9)
+           << ", \"p99\": " << h.percentile(0.99)
+           << ", \"p999\": " << h.percentile(0.999)
+           << ", \"max\": " << LoggerHistogram::lowerBound(last)
+           << ", \"buckets\": [";
+        bool first = true;
+        for (size_t b = 0; b < h.buckets.size(); b++) {
+            if (h.buckets[b] == 0)
+                continue;
+            os << (first ? "" : ", ") << "[" << LoggerHistogram::lowerBound(b) << ", " << h.buckets[b] << "]";
+            first = false;
+        }
+        os << "]}" << std::endl;
+    }
+}
+
+void Logger::measure(LoggerStage stage, int64_t start) {
+    int64_t elapsed = monotonicNano() - start;
+    size_t bucket = LoggerHistogram::bucketOf(elapsed > 0 ? (uint64_t) elapsed : 0);
+    histogramShards[shardIndex() % HISTOGRAM_SHARDS].buckets[stage][bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string Logger::getStageName(LoggerStage stage) {
+    switch (stage) {
+        case CAPTURE_STAGE:
+            return "capture";
+        case FORMAT_STAGE:
+            return "format";
+        case LOCK_STAGE:
+            return "lock";
+        case WRITE_STAGE:
+            return "write";
+        case SYNC_STAGE:
+            return "sync";
+
+        default:
+            return "";
+    }
+}
+
+void Logger::setClock(LoggerClockSource source) {
+#ifndef LOGGER_HAS_TSC
+    if (source == TSC_CLOCK)
+        source = REALTIME_CLOCK;
+#endif
+#ifndef CLOCK_REALTIME_COARSE
+    if (source == COARSE_CLOCK)
+        source = REALTIME_CLOCK;
+#endif
+    // Calibrate before the first stamp is taken
+    if (source == TSC_CLOCK)
+        calibrateClock(true);
+    clockSource = source;
+}
+
+void Logger::setFileMode(LoggerFileMode mode) {
+#ifdef _WIN32
+    mode = BUFFERED_FILE;
+#endif
+    if (!isInitialized)
+        fileMode = mode;
+    else
+        warning(__FUNCTION__, FILE_AND_CONSOLE, "File mode must be set before init\n");
+}
+
+void Logger::setFileShards(unsigned count) {
+    if (!isInitialized)
+        fileShardCount = count == 0 ? 1 : count < SHARDS ? count : (unsigned) SHARDS;
+    else
+        warning(__FUNCTION__, FILE_AND_CONSOLE, "File shards must be set before init\n");
+}
+
+void Logger::setTimeIndex(unsigned intervalKb) {
+    if (!isInitialized)
+        indexInterval = (uint64_t) intervalKb * 1024;
+    else
+        warning(__FUNCTION__, FILE_AND_CONSOLE, "Time index must be set before init\n");
+}
+
+bool Logger::mergeShards(const std::vector<std::string> &paths, std::ostream &out, int64_t windowNs) {
+    struct Log {
+        uint64_t number;
+        int64_t time;
+        /**
+         * The lines of the log without the number and the time, each followed by '\n'
+         */
+        std::string text;
+    };
+    struct Shard {
+        std::ifstream in;
+        /**
+         * First line of the log after next, empty at the end of the file
+         */
+        std::string line;
+        Log next;
+    };
+
+    // A log starts with its number and its time, both followed by a tab
+    auto parse = [](const std::string &line, uint64_t &number, int64_t &time, size_t &content) {
+        size_t tab = line.find('\t');
+        if (tab == 0 || tab == std::string::npos || line.find_first_not_of("0123456789") != tab)
+            return false;
+        size_t second = line.find('\t', tab + 1);
+        if (second == std::string::npos || second == tab + 1 ||
+            line.find_first_not_of("-0123456789", tab + 1) != second)
+            return false;
+        number = strtoull(line.c_str(), nullptr, 10);
+        time = strtoll(line.c_str() + tab + 1, nullptr, 10);
+        content = second + 1;
+        return true;
+    };
+
+    // Take the log whose first line is in shard.line, with the lines which belong to it
+    auto read = [&parse](Shard &shard) {
+        if (shard.line.empty())
+            return false;
+        size_t content = 0;
+        parse(shard.line, shard.next.number, shard.next.time, content);
+        shard.next.text.assign(shard.line, content, std::string::npos);
+        shard.next.text += '\n';
+        shard.line.clear();
+
+        uint64_t number;
+        int64_t time;
+        std::string line;
+        while (std::getline(shard.in, line)) {
+            if (parse(line, number, time, content)) {
+                shard.line = line;
+                break;
+            }
+            shard.next.text += line;
+            shard.next.text += '\n';
+        }
+        return true;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    for (const auto &path: paths) {
+        std::unique_ptr<Shard> shard(new Shard());
+        shard->in.open(path);
+        if (!shard->in.is_open())
+            return false;
+        shards.push_back(std::move(shard));
+    }
+
+    // Min-heap of the shards by the time of their next log : the times of a file are sorted, not its numbers
+    auto later = [](const Shard *a, const Shard *b) {
+        return a->next.time > b->next.time;
+    };
+    std::vector<Shard *> heap;
+    for (auto &shard: shards) {
+        uint64_t number;
+        int64_t time;
+        size_t content = 0;
+        while (std::getline(shard->in, shard->line)) {
+            if (parse(shard->line, number, time, content))
+                break;
+        }
+        if (!parse(shard->line, number, time, content))
+            shard->line.clear();
+        if (read(*shard))
+            heap.push_back(shard.get());
+    }
+    std::make_heap(heap.begin(), heap.end(), later);
+
+    // Min-heap of the logs read by their number. A log numbered before another one was written
+    // at most windowNs after it, so once a log is that old, no log read later has a smaller number
+    auto greater = [](const Log &a, const Log &b) {
+        return a.number > b.number;
+    };
+    std::vector<Log> pending;
+    auto emit = [&]() {
+        std::pop_heap(pending.begin(), pending.end(), greater);
+        out << pending.back().text;
+        pending.pop_back();
+    };
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        Shard *shard = heap.back();
+        int64_t frontier = shard->next.time;
+        pending.push_back(std::move(shard->next));
+        std::push_heap(pending.begin(), pending.end(), greater);
+        if (read(*shard))
+            std::push_heap(heap.begin(), heap.end(), later);
+        else
+            heap.pop_back();
+
+        while (!pending.empty() && frontier - pending.front().time > windowNs)
+            emit();
+    }
+    while (!pending.empty())
+        emit();
+
+    return !out.fail();
+}
+
+void Logger::setDurability(LoggerDurability durabilityP, const std::vector <LoggerType> &types, unsigned periodMs) {
+#ifdef _WIN32
+    durabilityP = NO_SYNC;
+#endif
+    for (const auto &type: types)
+        durability[type] = durabilityP;
+    if (durabilityP == PERIODIC_SYNC)
+        syncPeriod = (int64_t) periodMs * 1000000;
+}
+
+void Logger::enableFlightRecorder(size_t capacity, const std::vector <LoggerType> &types) {
+    if (capacity == 0) {
+        disableFlightRecorder();
+        return;
+    }
+
+    // Built before it is published, the logs never see it half initialized
+    auto *next = new FlightRecorder();
+    next->records.reset(new Record[capacity]);
+    for (size_t i = 0; i < capacity; i++) {
+        next->records[i].sequence = ~(uint64_t) 0;
+        // Room for a usual message, recording does not allocate while the ring fills
+        next->records[i].message.reserve(128);
+        next->records[i].lock.clear();
+    }
+    next->size = capacity;
+    next->types = 0;
+    for (const auto &type: types)
+        next->types |= (uint8_t) (1 << type);
+    next->head.store(0, std::memory_order_relaxed);
+    next->tail.store(0, std::memory_order_relaxed);
+    publishFlightRecorder(next);
+}
+
+void Logger::disableFlightRecorder() {
+    publishFlightRecorder(nullptr);
+}
+
+void Logger::dumpFlightRecorder() {
+    unsigned epoch;
+    const LoggerConfig *c = acquireConfig(epoch);
+    FlightRecorder *recorder = flightRecorder.load(std::memory_order_seq_cst);
+    if (recorder == nullptr) {
+        releaseConfig(epoch);
+        return;
+    }
+
+    mutex.lock(__FUNCTION__);
+    uint64_t head = recorder->head.load(std::memory_order_acquire);
+    uint64_t tail = recorder->tail.load(std::memory_order_relaxed);
+    uint64_t first = head - tail > recorder->size ? head - recorder->size : tail;
+    recorder->tail.store(head, std::memory_order_relaxed);
+
+    if (first < head && verbose != CONSOLE_ONLY) {
+        struct timespec now = stampToTime(clockStamp());
+        std::string title = "Flight recorder dump (" + std::to_string(head - first) + " logs)\n";
+        uint64_t number = nbLog++;
+        writeToFile(c->jsonFile ? constructJson(title, __FUNCTION__, INFO, now, number, nullptr, nullptr)
+                                : constructMessage(title, __FUNCTION__, getTypeName(INFO), c->fileFormat,
+                                                   c->fileKeys.data(), now, number, nullptr, &currentThread()), number, now);
+
+        for (uint64_t i = first; i < head; i++) {
+            Record &r = recorder->records[i % recorder->size];
+            while (r.lock.test_and_set(std::memory_order_acquire));
+            if (r.sequence == i && r.option != CONSOLE_ONLY) {
+                const Fields *fields = r.structured ? &r.fields : nullptr;
+                uint64_t number = nbLog++;
+                if (c->jsonFile) {
+                    writeToFile(constructJson(r.message, r.function, r.type, stampToTime(r.stamp), number, fields,
+                                              r.context.get()), number, stampToTime(r.stamp));
+                } else {
+                    std::string t = r.message;
+                    if (fields != nullptr)
+                        t += fields->text;
+                    if (t.empty() || t[t.length() - 1] != '\n')
+                        t += "\n";
+                    if (c->sanitize)
+                        sanitizeMessage(t);
+                    writeToFile(constructLines(t, r.function, getTypeName(r.type), c->fileFormat, c->fileKeys.data(), c->multiline,
+                                               stampToTime(r.stamp), number, r.context.get(), &r.thread), number,
+                                stampToTime(r.stamp));
+                }
+            }
+            r.lock.clear(std::memory_order_release);
+        }
+    }
+    mutex.unlock();
+    releaseConfig(epoch);
+}
+
+void Logger::dumpFlightRecorderOnSignal(int signal) {
+    std::signal(signal, flightRecorderSignal);
+}
+
+void Logger::flightRecorderSignal(int) {
+    flightRecorderRequested = flightRecorderRequested + 1;
+}
+
+void Logger::setModuleTypes(const std::string &module, const std::vector <LoggerType> &types) {
+    uint8_t mask = 0;
+    for (const auto &type: types)
+        mask |= (uint8_t) (1 << type);
+
+    pthread_mutex_lock(&moduleMutex);
+    moduleTypes[module] = mask;
+    LoggerModuleSite::generation.fetch_add(1, std::memory_order_release);
+    pthread_mutex_unlock(&moduleMutex);
+}
+
+void Logger::resetModuleTypes(const std::string &module) {
+    pthread_mutex_lock(&moduleMutex);
+    moduleTypes.erase(module);
+    LoggerModuleSite::generation.fetch_add(1, std::memory_order_release);
+    pthread_mutex_unlock(&moduleMutex);
+}
+
+std::vector<LoggerType> Logger::getModuleTypes(const std::string &module) {
+    uint8_t mask = moduleMask(module);
+    std::vector<LoggerType> res;
+    for (int type = 0; type <= DEBUG; type++)
+        if ((mask >> type & 1) != 0)
+            res.push_back((LoggerType) type);
+
+    return res;
+}
+
+uint8_t Logger::moduleMask(const std::string &module) {
+    uint8_t res = (uint8_t) ((1 << (DEBUG + 1)) - 1);
+
+    pthread_mutex_lock(&moduleMutex);
+    // "net.http", then "net", then ""
+    std::string name = module;
+    for (;;) {
+        auto it = moduleTypes.find(name);
+        if (it != moduleTypes.end()) {
+            res = it->second;
+            break;
+        }
+        if (name.empty())
+            break;
+        size_t dot = name.rfind('.');
+        name.resize(dot == std::string::npos ? 0 : dot);
+    }
+    pthread_mutex_unlock(&moduleMutex);
+
+    return res;
+}
+
+size_t Logger::enableSites(const std::string &pattern) {
+    return setSites(pattern, true);
+}
+
+size_t Logger::disableSites(const std::string &pattern) {
+    return setSites(pattern, false);
+}
+
+size_t Logger::setSites(const std::string &pattern, bool enabled) {
+    size_t res = 0;
+
+    pthread_mutex_lock(&siteMutex);
+    // The new rule overrides the previous ones with the same pattern
+    siteRules.erase(std::remove_if(siteRules.begin(), siteRules.end(),
+                                   [&pattern](const std::pair<std::string, bool> &rule) {
+                                       return rule.first == pattern;
+                                   }), siteRules.end());
+    siteRules.emplace_back(pattern, enabled);
+    for (LoggerSite *site = LoggerSite::head.load(std::memory_order_acquire); site != nullptr; site = site->next) {
+        if (site->matches(pattern)) {
+            site->enabled.store(enabled, std::memory_order_relaxed);
+            res++;
+        }
+    }
+    pthread_mutex_unlock(&siteMutex);
+
+    return res;
+}
+
+void Logger::listSites(std::ostream &os, const std::string &pattern) {
+    pthread_mutex_lock(&siteMutex);
+    for (LoggerSite *site = LoggerSite::head.load(std::memory_order_acquire); site != nullptr; site = site->next)
+        if (site->matches(pattern))
+            os << site->file << ":" << site->line << " " << site->function << " "
+               << (site->isEnabled() ? "+" : "-") << "\n";
+    pthread_mutex_unlock(&siteMutex);
+}
+
+bool Logger::openSiteControl(const std::string &path) {
+#ifndef _WIN32
+    closeSiteControl();
+
+    struct sockaddr_un address{};
+    if (path.length() >= sizeof(address.sun_path))
+        return false;
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    // Only a previous socket is replaced, never a file given by mistake
+    struct stat previous{};
+    if (lstat(path.c_str(), &previous) == 0 && !S_ISSOCK(previous.st_mode))
+        return false;
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0)
+        return false;
+    unlink(path.c_str());
+    int stop[2];
+    // Private to the user before listen(), no connection is accepted meanwhile
+    if (bind(server, (struct sockaddr *) &address, sizeof(address)) != 0 || chmod(path.c_str(), 0600) != 0 ||
+        listen(server, 4) != 0 || pipe(stop) != 0) {
+        ::close(server);
+        return false;
+    }
+    siteControlStop = stop[1];
+
+    siteControl = new std::thread([server, stop, path]() {
+        for (;;) {
+            struct pollfd fds[2] = {{server, POLLIN, 0}, {stop[0], POLLIN, 0}};
+            if (poll(fds, 2, -1) < 0 && errno != EINTR)
+                break;
+            if (fds[1].revents != 0)
+                break;
+            if ((fds[0].revents & POLLIN) == 0)
+                continue;
+
+            int client = accept(server, nullptr, nullptr);
+            if (client >= 0) {
+                serveSiteControl(client);
+                ::close(client);
+            }
+        }
+        ::close(server);
+        ::close(stop[0]);
+        unlink(path.c_str());
+    });
+
+    return true;
+#else
+    (void) path;
+    return false;
+#endif
+}
+
+void Logger::closeSiteControl() {
+#ifndef _WIN32
+    if (siteControlStop >= 0) {
+        char c = 0;
+        if (write(siteControlStop, &c, 1) < 0)
+            ERROR_LOG(CONSOLE_ONLY, "Cannot stop the site control\n");
+        siteControl->join();
+        delete siteControl;
+        siteControl = nullptr;
+        ::close(siteControlStop);
+        siteControlStop = -1;
+    }
+#endif
+}
+
+void Logger::serveSiteControl(int client) {
+#ifndef _WIN32
+    // A silent client does not hold the control for more than a second
+    struct timeval timeout{1, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string pending;
+    char buffer[512];
+    ssize_t n;
+    while ((n = read(client, buffer, sizeof(buffer))) > 0) {
+        pending.append(buffer, (size_t) n);
+        size_t end;
+        while ((end = pending.find('\n')) != std::string::npos) {
+            std::string command = pending.substr(0, end);
+            pending.erase(0, end + 1);
+            if (!command.empty() && command[command.length() - 1] == '\r')
+                command.resize(command.length() - 1);
+
+            std::string answer;
+            if (command.empty())
+                continue;
+            if (command[0] == '+' || command[0] == '-')
+                answer = std::to_string(setSites(command.substr(1), command[0] == '+')) + "\n";
+            else if (command[0] == '?') {
+                std::stringstream ss;
+                listSites(ss, command.length() > 1 ? command.substr(1) : "*");
+                answer = ss.str();
+            } else
+                answer = "Unknown command, use +pattern, -pattern or ?pattern\n";
+
+            for (size_t written = 0; written < answer.length();) {
+                ssize_t w = write(client, answer.data() + written, answer.length() - written);
+                if (w <= 0)
+                    return;
+                written += (size_t) w;
+            }
+        }
+    }
+#else
+    (void) client;
+#endif
+}
+
+bool Logger::record(FlightRecorder &recorder, const std::string &function, const std::string &message,
+                    LoggerType type, LoggerOption option, uint64_t stamp, const Fields *fields) {
+    if ((recorder.types >> type & 1) == 0)
+        return false;
+
+    uint64_t sequence = recorder.head.fetch_add(1, std::memory_order_acq_rel);
+    Record &r = recorder.records[sequence % recorder.size];
+    while (r.lock.test_and_set(std::memory_order_acquire));
+    // assign() reuses the slot's buffers, no allocation once the ring is warm
+    r.sequence = sequence;
+    r.stamp = stamp;
+    r.type = type;
+    r.option = option;
+    r.function.assign(function);
+    r.message.assign(message);
+    r.structured = fields != nullptr;
+    if (fields != nullptr) {
+        r.fields.text.assign(fields->text);
+        r.fields.json.assign(fields->json);
+    }
+    r.context = threadContext();
+    const Thread &thread = currentThread();
+    r.thread.id.assign(thread.id);
+    r.thread.name.assign(thread.name);
+    r.lock.clear(std::memory_order_release);
+
+    Counters &c = counters();
+    c.recorded.fetch_add(1, std::memory_order_relaxed);
+    uint64_t waiting = std::min<uint64_t>(sequence + 1 - recorder.tail.load(std::memory_order_relaxed),
+                                          recorder.size);
+    if (waiting > c.recorderHighWater.load(std::memory_order_relaxed))
+        c.recorderHighWater.store(waiting, std::memory_order_relaxed);
+
+    return true;
+}
+
+void Logger::genericLog(const std::string &function, const std::string &message, LoggerType type, LoggerOption option,
+                        const Fields *fields) {
+    uint64_t stamp = clockStamp();
+
+    int requested = flightRecorderRequested;
+    if (requested != flightRecorderSeen.load(std::memory_order_relaxed) &&
+        flightRecorderSeen.exchange(requested, std::memory_order_relaxed) != requested)
+        dumpFlightRecorder();
+
+    // The configuration and the flight recorder are not freed before releaseConfig()
+    unsigned epoch;
+    const LoggerConfig *configuration = acquireConfig(epoch);
+    FlightRecorder *recorder = flightRecorder.load(std::memory_order_seq_cst);
+    if (recorder != nullptr) {
+        if (record(*recorder, function, message, type, option, stamp, fields)) {
+            releaseConfig(epoch);
+            return;
+        }
+        if (type == ERROR && option != CONSOLE_ONLY)
+            dumpFlightRecorder();
+    }
+
+    struct timespec now = stampToTime(stamp);
+    const Context *context = threadContext().get();
+    const Thread *thread = &currentThread();
+
+    std::string t = message;
+
+    if (fields != nullptr) {
+        if (!t.empty() && t[t.length() - 1] == '\n')
+            t.insert(t.length() - 1, fields->text);
+        else
+            t += fields->text;
+    }
+    if (t.empty() || t[t.length() - 1] != '\n') {
+        t += "\n";
+    }
+
+    uint64_t number = nbLog.fetch_add(1, std::memory_order_relaxed);
+    Counters &c = counters();
+    c.messages[type].fetch_add(1, std::memory_order_relaxed);
+    if (configuration->sanitize)
+        sanitizeMessage(t);
+
+    if (option != FILE_ONLY && verbose != FILE_ONLY &&
+        std::find(showTypes.begin(), showTypes.end(), type) != showTypes.end()) {
+        std::string m = constructLines(t, function, getTypeName(type), configuration->consoleFormat,
+                                       configuration->consoleKeys.data(), configuration->multiline, now, number, context, thread);
+        std::cout << getTypeColor(type) << m << getColor(DEFAULT);
+        c.consoleBytes.fetch_add(m.length(), std::memory_order_relaxed);
+    }
+
+    if (option != CONSOLE_ONLY && verbose != CONSOLE_ONLY) {
+        std::string text;
+        const std::string &m = configuration->jsonFile
+                               ? constructJson(message, function, type, now, number, fields, context)
+                               : (text = constructLines(t, function, getTypeName(type), configuration->fileFormat,
+                                                        configuration->fileKeys.data(), configuration->multiline, now, number, context, thread));
+        if (fileMode != BUFFERED_FILE) {
+            writeToFile(m, number, now);
+        } else {
+            if (histogramsEnabled.load(std::memory_order_acquire)) {
+                int64_t start = monotonicNano();
+                mutex.lock(function.c_str());
+                measure(LOCK_STAGE, start);
+            } else
+                mutex.lock(function.c_str());
+            writeToFile(m, number, now);
+            mutex.unlock();
+        }
+        if (durability[type] != NO_SYNC) {
+            if (histogramsEnabled.load(std::memory_order_acquire)) {
+                int64_t start = monotonicNano();
+                syncFile(type);
+                measure(SYNC_STAGE, start);
+            } else
+                syncFile(type);
+        }
+    }
+
+    if (option != CONSOLE_ONLY && option != FILE_ONLY && verbose == FILE_AND_CONSOLE) {
+        for (const auto &os: additionalStreams) {
+            std::string m = constructLines(t, function, getTypeName(type), configuration->additionalFormat,
+                                           configuration->additionalKeys.data(), configuration->multiline, now, number, context, thread);
+            os->write(m.c_str(), (long) m.length());
+            os->flush();
+            if (os->fail())
+                c.writeErrors.fetch_add(1, std::memory_order_relaxed);
+            else
+                c.streamBytes.fetch_add(m.length(), std::memory_order_relaxed);
+        }
+    }
+
+    releaseConfig(epoch);
+}
+
+std::string Logger::constructMessage(const std::string &message, const std::string &trace, const std::string &logType,
+                                     const std::string &format, const size_t *keys, const struct timespec &now,
+                                     uint64_t number, const Context *context, const Thread *thread) {
+    int64_t start = histogramsEnabled.load(std::memory_order_acquire) ? monotonicNano() : 0;
+    std::string res;
+    struct tm local{};
+    localTime(now.tv_sec, local);
+    const struct tm *t = &local;
+
+    int i = 0;
+    while (i < format.length()) {
+        char c = format[i];
+        if (c == '%') {
+            i++;
+            c = format[i];
+
+            switch (c) {
+                case 'Y':
+                    res += std::to_string(t->tm_year + 1900);
+                    break;
+                case 'M':
+                    res += std::to_string(t->tm_mon + 1);
+                    break;
+                case 'D':
+                    res += std::to_string(t->tm_mday);
+                    break;
+                case 'H':
+                    res += std::to_string(t->tm_hour);
+                    break;
+                case 'm':
+                    res += std::to_string(t->tm_min);
+                    break;
+                case 'S':
+                    res += std::to_string(t->tm_sec);
+                    break;
+                case 'N':
+                    res += std::to_string(now.tv_nsec);
+                    break;
+                case 'd':
+                    res += getDate(now);
+                    break;
+                case 'h':
+                    res += getHour(now);
+                    break;
+                case 'T':
+                    res += trace;
+                    break;
+                case 'C':
+                    res += message;
+                    break;
+                case 'n':
+                    res += std::to_string(number);
+                    break;
+                case 't':
+                    res += logType;
+                    break;
+                case 'i':
+                    if (thread != nullptr)
+                        res += thread->id;
+                    break;
+                case 'I':
+                    if (thread != nullptr)
+                        res += thread->name;
+                    break;
+                case 'X':
+                    if ((size_t) i + 1 < format.length() && format[i + 1] == '{') {
+                        size_t end = format.find('}', i + 2);
+                        if (end == std::string::npos)
+                            end = format.length();
+                        // Resolved when the format was published, rendered when the context changed
+                        size_t id = *keys++;
+                        if (context != nullptr && id < context->values.size())
+                            res += context->values[id];
+                        i = (int) end;
+                    } else if (context != nullptr)
+                        res += context->text;
+                    break;
+                default:
+                    break;
+            }
+        } else {
+            res += c;
+        }
+
+        i++;
+    }
+
+    if (start != 0)
+        measure(FORMAT_STAGE, start);
+
+    return res;
+}
+
+std::string Logger::constructLines(const std::string &message, const std::string &trace, const std::string &logType,
+                                   const std::string &format, const size_t *keys, bool multiline,
+                                   const struct timespec &now, uint64_t number, const Context *context,
+                                   const Thread *thread) {
+    // glibc memchr scans 16 or 32 bytes at once, a message of one line costs a single call
+    size_t length = message.length() - 1;
+    const char *data = message.data();
+    if (!multiline || memchr(data, '\n', length) == nullptr)
+        return constructMessage(message, trace, logType, format, keys, now, number, context, thread);
+
+    size_t content = format.find("%C");
+    if (content == std::string::npos)
+        return constructMessage(message, trace, logType, format, keys, now, number, context, thread);
+
+    std::string before = format.substr(0, content);
+    size_t from = 0;
+    std::string key;
+    const size_t *after = keys;
+    while (nextFormatKey(before, from, key))
+        after++;
+    std::string prefix = constructMessage("", trace, logType, before, keys, now, number, context, thread);
+    std::string suffix = constructMessage("", trace, logType, format.substr(content + 2), after, now, number, context,
+                                          thread);
+
+    std::string res;
+    res.reserve(message.length() + (prefix.length() + 1) * 4 + suffix.length());
+    size_t i = 0;
+    while (i <= length) {
+        const void *found = memchr(data + i, '\n', length - i);
+        size_t end = found == nullptr ? length : (const char *) found - data;
+        res += prefix;
+        res.append(data + i, end + 1 - i);
+        i = end + 1;
+    }
+    res += suffix;
+
+    return res;
+}
+
+const std::string &Logger::constructJson(const std::string &message, const std::string &trace, LoggerType type,
+                                        const struct timespec &now, uint64_t number, const Fields *fields,
+                                        const Context *context) {
+    int64_t start = histogramsEnabled.load(std::memory_order_acquire) ? monotonicNano() : 0;
+    // Reused by the thread, no allocation once it is large enough
+    static thread_local std::string res;
+    res.clear();
+
+    struct tm t{};
+    localTime(now.tv_sec, t);
+    char time[48];
+    int n = snprintf(time, sizeof(time), "%04d-%02d-%02dT%02d:%02d:%02d.%09ld", t.tm_year + 1900, t.tm_mon + 1,
+                     t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec, (long) now.tv_nsec);
+    char seq[24];
+    int m = snprintf(seq, sizeof(seq), "%llu", (unsigned long long) number);
+
+    res += "{\"seq\":";
+    res.append(seq, (size_t) m);
+    res += ",\"time\":\"";
+    res.append(time, (size_t) n);
+    res += "\",\"level\":\"";
+    res += getTypeName(type);
+    res += "\",\"trace\":";
+    appendJsonString(res, trace.data(), trace.length());
+    res += ",\"message\":";
+    size_t length = message.length();
+    if (length > 0 && message[length - 1] == '\n')
+        length--;
+    appendJsonString(res, message.data(), length);
+    if (fields != nullptr)
+        res += fields->json;
+    if (context != nullptr)
+        res += context->json;
+    res += "}\n";
+
+    if (start != 0)
+        measure(FORMAT_STAGE, start);
+
+    return res;
+}
+
+void Logger::appendJsonString(std::string &out, const char *data, size_t length) {
+    out += '"';
+    escape(out, data, length, true);
+    out += '"';
+}
+
+/**
+ * Length of the UTF-8 sequence starting at data, 0 if it is invalid (overlong, surrogate, above U+10FFFF or cut)
+ */
+static size_t utf8Length(const unsigned char *data, size_t length) {
+    unsigned char c = data[0];
+    size_t n;
+    unsigned char low = 0x80, high = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF)
+        n = 2;
+    else if (c >= 0xE0 && c <= 0xEF) {
+        n = 3;
+        if (c == 0xE0)
+            low = 0xA0;
+        else if (c == 0xED)
+            high = 0x9F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        n = 4;
+        if (c == 0xF0)
+            low = 0x90;
+        else if (c == 0xF4)
+            high = 0x8F;
+    } else
+        return 0;
+
+    if (length < n || data[1] < low || data[1] > high)
+        return 0;
+    for (size_t i = 2; i < n; i++)
+        if ((data[i] & 0xC0) != 0x80)
+            return 0;
+
+    return n;
+}
+
+void Logger::escape(std::string &out, const char *data, size_t length, bool json) {
+    static const char hex[] = "0123456789abcdef";
+
+    size_t i = 0;
+    while (i < length) {
+        size_t next = i + findEscape(data + i, length - i, json);
+        // Copy the run of characters which need no escape at once
+        out.append(data + i, next - i);
+        if (next == length)
+            break;
+
+        auto c = (unsigned char) data[next];
+        i = next + 1;
+        // findEscape() skips the valid UTF-8 sequences, so this byte starts an invalid one
+        if (c >= 0x80) {
+            if (json)
+                out += "\\ufffd";
+            else {
+                out += "\\x";
+                out += hex[c >> 4];
+                out += hex[c & 15];
+            }
+            continue;
+        }
+
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                out += json ? "\\u00" : "\\x";
+                out += hex[c >> 4];
+                out += hex[c & 15];
+                break;
+        }
+    }
+}
+
+static size_t findEscapeScalar(const char *data, size_t length, bool json) {
+    for (size_t i = 0; i < length; i++) {
+        auto c = (unsigned char) data[i];
+        if (c < 0x20 || c >= 0x7F) {
+            if (c != 0x7F || !json)
+                return i;
+        } else if (json && (c == '"' || c == '\\'))
+            return i;
+    }
+
+    return length;
+}
+
+#ifdef __SSE2__
+static size_t findEscapeSse2(const char *data, size_t length, bool json) {
+    // Signed compare : the bytes below 0x20 and the non-ASCII ones (negative) are both less than 0x20
+    const __m128i space = _mm_set1_epi8(0x20);
+    const __m128i first = _mm_set1_epi8(json ? '"' : 0x7F);
+    const __m128i second = _mm_set1_epi8(json ? '\\' : 0x7F);
+
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (data + i));
+        __m128i special = _mm_or_si128(_mm_cmplt_epi8(v, space),
+                                       _mm_or_si128(_mm_cmpeq_epi8(v, first), _mm_cmpeq_epi8(v, second)));
+        int mask = _mm_movemask_epi8(special);
+        if (mask != 0)
+            return i + (size_t) __builtin_ctz((unsigned) mask);
+    }
+
+    return i + findEscapeScalar(data + i, length - i, json);
+}
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LOGGER_HAS_AVX2
+
+__attribute__((target("avx2")))
+static size_t findEscapeAvx2(const char *data, size_t length, bool json) {
+    const __m256i space = _mm256_set1_epi8(0x20);
+    const __m256i first = _mm256_set1_epi8(json ? '"' : 0x7F);
+    const __m256i second = _mm256_set1_epi8(json ? '\\' : 0x7F);
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *) (data + i));
+        // No signed "less than" in AVX2, 0x20 > v is the same
+        __m256i special = _mm256_or_si256(_mm256_cmpgt_epi8(space, v),
+                                          _mm256_or_si256(_mm256_cmpeq_epi8(v, first),
+                                                          _mm256_cmpeq_epi8(v, second)));
+        auto mask = (unsigned) _mm256_movemask_epi8(special);
+        if (mask != 0)
+            return i + (size_t) __builtin_ctz(mask);
+    }
+
+    return i + findEscapeSse2(data + i, length - i, json);
+}
+#endif
+
+static size_t findSpecial(const char *data, size_t length, bool json) {
+#ifdef LOGGER_HAS_AVX2
+    static const bool avx2 = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    if (avx2)
+        return findEscapeAvx2(data, length, json);
+#endif
+#ifdef __SSE2__
+    return findEscapeSse2(data, length, json);
+#else
+    return findEscapeScalar(data, length, json);
+#endif
+}
+
+size_t Logger::findEscape(const char *data, size_t length, bool json) {
+    // The vector scans stop on each non-ASCII byte, a valid UTF-8 sequence is checked and skipped here
+    size_t i = 0;
+    for (;;) {
+        i += findSpecial(data + i, length - i, json);
+        if (i == length || (unsigned char) data[i] < 0x80)
+            return i;
+        size_t n = utf8Length((const unsigned char *) data + i, length - i);
+        if (n == 0)
+            return i;
+        i += n;
+    }
+}
+
+void Logger::sanitizeMessage(std::string &t) {
+    size_t length = t.length();
+    if (length > 0 && t[length - 1] == '\n')
+        length--;
+    // Clean messages are only scanned
+    if (findEscape(t.data(), length, false) == length)
+        return;
+
+    std::string res;
+    res.reserve(t.length() + 16);
+    escape(res, t.data(), length, false);
+    res.append(t, length, std::string::npos);
+    t.swap(res);
+}
+
+#ifndef _WIN32
+/**
+ * pwrite() the whole data, or as much as possible, and return the number of bytes written
+ */
+static size_t writeAt(int descriptor, const char *data, size_t length, int64_t offset) {
+    size_t written = 0;
+    while (written < length) {
+        ssize_t n = pwrite(descriptor, data + written, length - written, (off_t) (offset + (int64_t) written));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        written += (size_t) n;
+    }
+
+    return written;
+}
+#endif
+
+void Logger::writeToFile(const std::string &message, uint64_t number, const struct timespec &now) {
+    int64_t start = histogramsEnabled.load(std::memory_order_acquire) ? monotonicNano() : 0;
+#ifndef _WIN32
+    if (fileShards) {
+        unsigned index = shardIndex() % fileShardCount;
+        FileShard &shard = fileShards[index];
+        char header[48];
+
+        pthread_mutex_lock(&shard.mutex);
+        if (shard.descriptor < 0)
+            shard.descriptor = ::open((fileShardBase + "." + std::to_string(index) + ".log").c_str(),
+                                      O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP);
+        // The time is taken under the lock, so the times of a file are sorted and mergeShards() can merge by time
+        auto n = (size_t) snprintf(header, sizeof(header), "%llu\t%lld\t", (unsigned long long) number,
+                                   (long long) monotonicNano());
+        size_t length = n + message.length();
+        size_t written = 0;
+        while (shard.descriptor >= 0 && written < length) {
+            // The header and the message in one write, without joining them
+            struct iovec parts[2];
+            int count = 0;
+            if (written < n) {
+                parts[count++] = {header + written, n - written};
+                parts[count++] = {(void *) message.data(), message.length()};
+            } else
+                parts[count++] = {(void *) (message.data() + written - n), length - written};
+            ssize_t w = writev(shard.descriptor, parts, count);
+            if (w < 0 && errno == EINTR)
+                continue;
+            if (w <= 0)
+                break;
+            written += (size_t) w;
+        }
+        shard.written++;
+        pthread_mutex_unlock(&shard.mutex);
+
+        Counters &c = counters();
+        if (written < length)
+            c.writeErrors.fetch_add(1, std::memory_order_relaxed);
+        c.fileBytes.fetch_add(written, std::memory_order_relaxed);
+        c.flushes.fetch_add(1, std::memory_order_relaxed);
+        writtenCount.fetch_add(1, std::memory_order_release);
+        if (start != 0)
+            measure(WRITE_STAGE, start);
+        return;
+    }
+    if (fileDescriptor >= 0) {
+        // The range is reserved before the write, so concurrent lines never overlap
+        int64_t offset = fileOffset.fetch_add((int64_t) message.length(), std::memory_order_relaxed);
+        if (indexDescriptor >= 0)
+            indexLine((uint64_t) offset, number, now);
+        size_t written = writeAt(fileDescriptor, message.data(), message.length(), offset);
+        Counters &c = counters();
+        if (written < message.length()) {
+            c.writeErrors.fetch_add(1, std::memory_order_relaxed);
+            // The range stays reserved : fill it with spaces and a '\n' rather than leave NUL bytes,
+            // so the next lines and the offsets of the time index stay on line boundaries
+            std::string padding(message.length() - written, ' ');
+            padding[padding.length() - 1] = '\n';
+            writeAt(fileDescriptor, padding.data(), padding.length(), offset + (int64_t) written);
+        }
+        c.fileBytes.fetch_add(written, std::memory_order_relaxed);
+        c.flushes.fetch_add(1, std::memory_order_relaxed);
+        writtenCount.fetch_add(1, std::memory_order_release);
+        if (start != 0)
+            measure(WRITE_STAGE, start);
+        return;
+    }
+#endif
+
+    if (file.is_open()) {
+        // Under the logger's mutex, the lines are written in the order of their offset
+        int64_t offset = fileOffset.fetch_add((int64_t) message.length(), std::memory_order_relaxed);
+        if (indexDescriptor >= 0)
+            indexLine((uint64_t) offset, number, now);
+        file << message;
+        file.flush();
+        Counters &c = counters();
+        if (file.fail()) {
+            c.writeErrors.fetch_add(1, std::memory_order_relaxed);
+            file.clear();
+        } else
+            c.fileBytes.fetch_add(message.length(), std::memory_order_relaxed);
+        c.flushes.fetch_add(1, std::memory_order_relaxed);
+        writtenCount.fetch_add(1, std::memory_order_release);
+        if (start != 0)
+            measure(WRITE_STAGE, start);
+    } else if (!isInitialized)
+        error(__FUNCTION__, CONSOLE_ONLY, "Please init logger\n");
+}
+
+void Logger::openFile(const std::string &fileName) {
+    fileOffset = 0;
+#ifndef _WIN32
+    if (indexInterval > 0 && fileMode != SHARDED_FILE) {
+        indexDescriptor = ::open((fileName + ".idx").c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                                 S_IRUSR | S_IWUSR | S_IRGRP);
+        if (indexDescriptor >= 0 && write(indexDescriptor, LOGGER_INDEX_MAGIC, sizeof(LOGGER_INDEX_MAGIC)) < 0) {
+            ::close(indexDescriptor);
+            indexDescriptor = -1;
+        }
+        nextIndexOffset = 0;
+        lastIndexTime = 0;
+    }
+    if (fileMode == SHARDED_FILE) {
+        fileShardBase = fileName.substr(0, fileName.length() - 4);
+        // On their cache lines even before C++17, whose new[] ignores the alignment
+        void *memory = nullptr;
+        if (posix_memalign(&memory, alignof(FileShard), sizeof(FileShard) * fileShardCount) != 0)
+            return;
+        fileShards = (FileShard *) memory;
+        for (unsigned i = 0; i < fileShardCount; i++) {
+            new(&fileShards[i]) FileShard();
+            pthread_mutex_init(&fileShards[i].mutex, nullptr);
+            pthread_cond_init(&fileShards[i].syncCondition, nullptr);
+            fileShards[i].descriptor = -1;
+            fileShards[i].written = 0;
+            fileShards[i].synced = 0;
+            fileShards[i].syncing = false;
+            fileShards[i].lastSync.store(0, std::memory_order_relaxed);
+        }
+        return;
+    }
+    if (fileMode == DIRECT_FILE) {
+        fileDescriptor = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP);
+        fileOffset = 0;
+        syncDescriptor = fileDescriptor;
+        return;
+    }
+#endif
+
+    file.open(fileName, std::ios::out);
+#ifndef _WIN32
+    // std::ofstream hides its descriptor, any descriptor of the file syncs the same data
+    if (file.is_open())
+        syncDescriptor = ::open(fileName.c_str(), O_WRONLY);
+#endif
+}
+
+void Logger::closeFile() {
+#ifndef _WIN32
+    bool durable = false;
+    for (const auto &d: durability)
+        durable = durable || d != NO_SYNC;
+    if (syncDescriptor >= 0) {
+        if (durable) {
+            if (file.is_open())
+                file.flush();
+            dataSync(syncDescriptor);
+        }
+        if (syncDescriptor != fileDescriptor)
+            ::close(syncDescriptor);
+        syncDescriptor = -1;
+    }
+    if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+    if (indexDescriptor >= 0) {
+        ::close(indexDescriptor);
+        indexDescriptor = -1;
+    }
+    if (fileShards) {
+        for (unsigned i = 0; i < fileShardCount; i++) {
+            if (fileShards[i].descriptor >= 0) {
+                if (durable)
+                    dataSync(fileShards[i].descriptor);
+                ::close(fileShards[i].descriptor);
+            }
+            pthread_cond_destroy(&fileShards[i].syncCondition);
+            pthread_mutex_destroy(&fileShards[i].mutex);
+            fileShards[i].~FileShard();
+        }
+        free(fileShards);
+        fileShards = nullptr;
+    }
+#endif
+
+    if (file.is_open())
+        file.close();
+}
+
+void Logger::indexLine(uint64_t offset, uint64_t number, const struct timespec &now) {
+#ifndef _WIN32
+    // Most lines stop here, the lock is only taken once per interval
+    if (offset < nextIndexOffset.load(std::memory_order_relaxed))
+        return;
+
+    pthread_mutex_lock(&indexMutex);
+    if (offset >= nextIndexOffset.load(std::memory_order_relaxed)) {
+        nextIndexOffset.store(offset + indexInterval, std::memory_order_relaxed);
+        // A log timed before the previous entry may reach the file after it, the search needs sorted times
+        int64_t time = std::max(lastIndexTime, (int64_t) now.tv_sec * 1000000000 + now.tv_nsec);
+        lastIndexTime = time;
+        LoggerIndexEntry entry = {time, number, offset};
+        if (write(indexDescriptor, &entry, sizeof(entry)) != (ssize_t) sizeof(entry))
+            counters().writeErrors.fetch_add(1, std::memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&indexMutex);
+#endif
+}
+
+bool Logger::isFileOpen() {
+    return fileDescriptor >= 0 || fileShards || file.is_open();
+}
+
+void Logger::syncFile(LoggerType type) {
+#ifndef _WIN32
+    if (fileShards) {
+        // The shard is only written by its threads, each log syncs its own file
+        syncShard(fileShards[shardIndex() % fileShardCount], type);
+        return;
+    }
+
+    if (syncDescriptor < 0)
+        return;
+
+    if (durability[type] == PERIODIC_SYNC) {
+        int64_t now = monotonicNano();
+        int64_t last = lastSync.load(std::memory_order_relaxed);
+        // Only the log which moves lastSync forward runs the sync
+        if (now - last >= syncPeriod && lastSync.compare_exchange_strong(last, now, std::memory_order_relaxed))
+            dataSync(syncDescriptor);
+        return;
+    }
+
+    // Group commit : the writes counted before a fdatasync() starts are on the disk when it returns
+    uint64_t mine = writtenCount.load(std::memory_order_acquire);
+    pthread_mutex_lock(&syncMutex);
+    while (syncedCount < mine) {
+        if (syncing) {
+            pthread_cond_wait(&syncCondition, &syncMutex);
+            continue;
+        }
+
+        syncing = true;
+        uint64_t target = writtenCount.load(std::memory_order_acquire);
+        pthread_mutex_unlock(&syncMutex);
+        dataSync(syncDescriptor);
+        pthread_mutex_lock(&syncMutex);
+        if (target > syncedCount)
+            syncedCount = target;
+        syncing = false;
+        pthread_cond_broadcast(&syncCondition);
+    }
+    pthread_mutex_unlock(&syncMutex);
+#endif
+}
+
+void Logger::syncShard(FileShard &shard, LoggerType type) {
+#ifndef _WIN32
+    if (durability[type] == PERIODIC_SYNC) {
+        int64_t now = monotonicNano();
+        int64_t last = shard.lastSync.load(std::memory_order_relaxed);
+        // The descriptor was set under the mutex by the write of this log
+        if (now - last >= syncPeriod && shard.lastSync.compare_exchange_strong(last, now, std::memory_order_relaxed) &&
+            shard.descriptor >= 0)
+            dataSync(shard.descriptor);
+        return;
+    }
+
+    // Group commit of the shard, as syncFile() does for the single file
+    pthread_mutex_lock(&shard.mutex);
+    uint64_t mine = shard.written;
+    while (shard.synced < mine) {
+        if (shard.syncing) {
+            pthread_cond_wait(&shard.syncCondition, &shard.mutex);
+            continue;
+        }
+
+        shard.syncing = true;
+        uint64_t target = shard.written;
+        int descriptor = shard.descriptor;
+        // The next lines of the shard are written during the fdatasync()
+        pthread_mutex_unlock(&shard.mutex);
+        if (descriptor >= 0)
+            dataSync(descriptor);
+        pthread_mutex_lock(&shard.mutex);
+        if (target > shard.synced)
+            shard.synced = target;
+        shard.syncing = false;
+        pthread_cond_broadcast(&shard.syncCondition);
+    }
+    pthread_mutex_unlock(&shard.mutex);
+#endif
+}
+
+void Logger::dataSync(int descriptor) {
+#ifndef _WIN32
+    Counters &c = counters();
+    if (fdatasync(descriptor) != 0)
+        c.writeErrors.fetch_add(1, std::memory_order_relaxed);
+    c.syncs.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+void Logger::flushLimiter(LoggerLimiter &limiter) {
+    limiter.lastSummary.store(monotonicNano(), std::memory_order_relaxed);
+    uint64_t repeated = limiter.repeated.exchange(0, std::memory_order_relaxed);
+    if (repeated > 0)
+        genericLog(limiter.function, "Last message repeated " + std::to_string(repeated) + " times",
+                   limiter.type, limiter.option);
+
+    uint64_t dropped = limiter.dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0)
+        genericLog(limiter.function, std::to_string(dropped) + " messages suppressed by rate limit",
+                   limiter.type, limiter.option);
+}
+
+void Logger::adoptLimiter(LoggerLimiter &limiter) {
+    Logger *previous = limiter.owner.exchange(this, std::memory_order_acq_rel);
+    if (previous == this)
+        return;
+
+    // The previous owner clears itself before it is destroyed
+    if (previous != nullptr)
+        previous->flushLimiter(limiter);
+    limiter.forget();
+}
+
+int64_t Logger::monotonicNow() {
+    return monotonicNano();
+}
+
+uint64_t Logger::clockStamp() {
+    switch (clockSource) {
+        case TSC_CLOCK:
+            return readTsc();
+#ifdef CLOCK_REALTIME_COARSE
+        case COARSE_CLOCK: {
+            struct timespec now{};
+            clock_gettime(CLOCK_REALTIME_COARSE, &now);
+            return (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_nsec;
+        }
+#endif
+
+        default:
+            return (uint64_t) realtimeNano();
+    }
+}
+
+struct timespec Logger::stampToTime(uint64_t stamp) {
+    int64_t ns = (int64_t) stamp;
+
+    if (clockSource == TSC_CLOCK) {
+        uint32_t sequence;
+        uint64_t base;
+        int64_t baseNs;
+        double rate;
+        do {
+            sequence = clockSequence.load(std::memory_order_acquire);
+            base = tscBase.load(std::memory_order_relaxed);
+            baseNs = tscBaseNs.load(std::memory_order_relaxed);
+            rate = tscRate.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((sequence & 1) != 0 || sequence != clockSequence.load(std::memory_order_relaxed));
+
+        int64_t ticks = (int64_t) (stamp - base);
+        if (ticks > (int64_t) tscResync.load(std::memory_order_relaxed))
+            calibrateClock(false);
+        ns = baseNs + (int64_t) ((double) ticks * rate);
+    }
+
+    struct timespec res{};
+    res.tv_sec = (time_t) (ns / 1000000000);
+    res.tv_nsec = (long) (ns % 1000000000);
+
+    return res;
+}
+
+void Logger::calibrateClock(bool initial) {
+    if (tscCalibrating.exchange(true, std::memory_order_acquire))
+        return;
+
+    uint64_t tsc = readTsc();
+    int64_t ns = realtimeNano();
+    double rate = tscRate.load(std::memory_order_relaxed);
+
+    if (initial) {
+        uint64_t firstTsc = tsc;
+        int64_t firstNs = ns;
+        do {
+            tsc = readTsc();
+            ns = realtimeNano();
+        } while (ns - firstNs < 1000000);
+        if (tsc > firstTsc)
+            rate = (double) (ns - firstNs) / (double) (tsc - firstTsc);
+    } else {
+        uint64_t base = tscBase.load(std::memory_order_relaxed);
+        double measured = (double) (ns - tscBaseNs.load(std::memory_order_relaxed)) / (double) (tsc - base);
+        // A step of the wall clock (NTP, settimeofday) only moves the base, not the rate
+        if (tsc > base && measured > rate * 0.99 && measured < rate * 1.01)
+            rate = measured;
+    }
+
+    clockSequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    tscBase.store(tsc, std::memory_order_relaxed);
+    tscBaseNs.store(ns, std::memory_order_relaxed);
+    tscRate.store(rate, std::memory_order_relaxed);
+    clockSequence.fetch_add(1, std::memory_order_release);
+
+    tscResync.store((uint64_t) (1000000000 / rate), std::memory_order_relaxed);
+    tscCalibrating.store(false, std::memory_order_release);
+}
+
+std::string Logger::getHour(const struct timespec &now) {
+    struct tm t{};
+    localTime(now.tv_sec, t);
+
+    return std::to_string(t.tm_hour) + ":"
+           + std::to_string(t.tm_min) + ":"
+           + std::to_string(t.tm_sec) + ":"
            + std::to_string(now.tv_nsec);
 }
 
-std::string Logger::getDate() {
-    time_t now;
-    time(&now);
-    struct tm *t = localtime(&now);
+std::string Logger::getDate(const struct timespec &now) {
+    struct tm t{};
+    localTime(now.tv_sec, t);
+
+    return std::to_string(t.tm_year + 1900) + "-"
+           + std::to_string(t.tm_mon + 1) + "-"
+           + std::to_string(t.tm_mday) + "@"
+           + std::to_string(t.tm_hour) + "-"
+           + std::to_string(t.tm_min) + "-"
+           + std::to_string(t.tm_sec);
+}
+
+/**
+ * UTC offset of the system's time zone at an instant, in seconds
+ */
+static int32_t utcOffsetAt(time_t seconds) {
+    struct tm local{};
+    struct tm utc{};
+#ifdef _WIN32
+    localtime_s(&local, &seconds);
+    gmtime_s(&utc, &seconds);
+#else
+    localtime_r(&seconds, &local);
+    gmtime_r(&seconds, &utc);
+#endif
+    int days = local.tm_year != utc.tm_year ? (local.tm_year > utc.tm_year ? 1 : -1)
+                                            : local.tm_yday - utc.tm_yday;
+
+    return (int32_t) (days * 86400 + (local.tm_hour - utc.tm_hour) * 3600
+                      + (local.tm_min - utc.tm_min) * 60 + (local.tm_sec - utc.tm_sec));
+}
+
+void Logger::localTime(time_t seconds, struct tm &res) {
+    // Offset of the quarters where it changes, which are converted by the system
+    static const int32_t CHANGING = INT32_MIN;
+
+    // Quarters of an hour (since the epoch) and their UTC offset in seconds, the current one first
+    static thread_local int64_t quarters[2] = {INT64_MIN, INT64_MIN};
+    static thread_local int32_t offsets[2] = {0, 0};
+
+    int64_t quarter = (int64_t) seconds / 900 - ((int64_t) seconds % 900 < 0 ? 1 : 0);
+    int32_t offset;
+
+    if (quarters[0] == quarter) {
+        offset = offsets[0];
+    } else if (quarters[1] == quarter) {
+        offset = offsets[1];
+    } else {
+        // The first thread to reach a quarter re-reads TZ, tzset() frees and rebuilds the zone of the process
+        static std::atomic<int64_t> tzQuarter(INT64_MIN);
+        int64_t checked = tzQuarter.load(std::memory_order_relaxed);
+        if (quarter > checked && tzQuarter.compare_exchange_strong(checked, quarter, std::memory_order_relaxed))
+#ifdef _WIN32
+            _tzset();
+#else
+            tzset();
+#endif
+
+        // Once per quarter of an hour, ask the system (and its time zone lock) at both ends of the quarter :
+        // most zones change on a quarter, a few changed at other minutes (America/St_Johns at 00:01)
+        offset = utcOffsetAt((time_t) (quarter * 900));
+        if (utcOffsetAt((time_t) (quarter * 900 + 899)) != offset)
+            offset = CHANGING;
+        quarters[1] = quarters[0];
+        offsets[1] = offsets[0];
+        quarters[0] = quarter;
+        offsets[0] = offset;
+    }
+
+    if (offset == CHANGING) {
+#ifdef _WIN32
+        localtime_s(&res, &seconds);
+#else
+        localtime_r(&seconds, &res);
+#endif
+        return;
+    }
+
+    int64_t t = (int64_t) seconds + offset;
+    int64_t days = t / 86400 - (t % 86400 < 0 ? 1 : 0);
+    int64_t secondsOfDay = t - days * 86400;
+
+    res.tm_hour = (int) (secondsOfDay / 3600);
+    res.tm_min = (int) (secondsOfDay / 60 % 60);
+    res.tm_sec = (int) (secondsOfDay % 60);
+
+    // Civil date from the days since 1970-01-01, in eras of 400 years starting on March 1st
+    int64_t z = days + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t dayOfEra = z - era * 146097;
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t mp = (5 * dayOfYear + 2) / 153;
+    int64_t day = dayOfYear - (153 * mp + 2) / 5 + 1;
+    int64_t month = mp < 10 ? mp + 3 : mp - 9;
+    int64_t year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
 
-    return std::to_string(t->tm_year + 1900) + "-"
-           + std::to_string(t->tm_mon + 1) + "-"
-           + std::to_string(t->tm_mday) + "@"
-           + std::to_string(t->tm_hour) + "-"
-           + std::to_string(t->tm_min) + "-"
-           + std::to_string(t->tm_sec);
+    res.tm_year = (int) (year - 1900);
+    res.tm_mon = (int) (month - 1);
+    res.tm_mday = (int) day;
 }
\ No newline at end of file
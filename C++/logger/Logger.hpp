@@ -11,6 +11,14 @@
 #include <cstring>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <map>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
 
 /*
  * Logger
@@ -25,21 +33,29 @@
  * INFO_LOG(CONSOLE_ONLY, "Not too complex ? ", "Maybe");
  * Write 'Not toot complex ? Maybe' (without the quote) only in the console
  *
+ * Several loggers :
+ * Logger audit("audit");
+ * audit.setDurability(GROUP_COMMIT);
+ * audit.open(FILE_ONLY);
+ * INFO_LOG_TO(audit, FILE_ONLY, "Access granted");
+ * audit.close();
+ * Each logger has its own file, formats, types, mutex and counters, the macros without _TO use Logger::global()
+ *
  * <!> WARNING <!>
  * Need -lphtread option for compilation
  * <!> WARNING <!>
  */
 
 /**
- * The log directory's path
- * Change it with your path
+ * Default log directory's path, "./logs", of Logger::global() and of the loggers built without a path
+ * Assign it before the first log of Logger::global(), or give the path to the Logger constructor
  */
-static std::string LOG_PATH = "./logs";
+extern const char *LOG_PATH;
 /**
- * Project's name
- * Change it with your project's name
+ * Default project's name, "project", of Logger::global() and of the loggers built without a name
+ * Assign it before the first log of Logger::global(), or give the name to the Logger constructor
  */
-static std::string PROJECT_NAME = "project";
+extern const char *PROJECT_NAME;
 
 /*
  * Different rules for the formats :
@@ -56,22 +72,26 @@ static std::string PROJECT_NAME = "project";
  * %C -> Content message
  * %n -> Log number
  * %t -> Log type
+ * %i -> Thread id (the kernel's on Linux)
+ * %I -> Thread name (see Logger::setThreadName())
+ * %X{key} -> Value of the key in the thread's context (see Logger::setContext())
+ * %X -> The whole context of the thread (key=value key=value)
  */
 
 /**
- * Format for console log
+ * Default format for console log, "[%T]\t%C", change it with Logger::setFormats()
  */
-static std::string CONSOLE_FORMAT = "[%T]\t%C";
+extern const char *const CONSOLE_FORMAT;
 
 /**
- * Format for log file
+ * Default format for log file, "[%n-%h-%t]\t[%T]\t%C", change it with Logger::setFormats()
  */
-static std::string FILE_FORMAT = "[%n-%h-%t]\t[%T]\t%C";
+extern const char *const FILE_FORMAT;
 
 /**
- * Format for additional output stream
+ * Default format for additional output stream, "[%n-%t]\t[%T]\t%C", change it with Logger::setFormats()
  */
-static std::string ADDITIONAL_FORMAT = "[%n-%t]\t[%T]\t%C";
+extern const char *const ADDITIONAL_FORMAT;
 
 // _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
 
@@ -121,231 +141,2395 @@ typedef enum LoggerOption {
     FILE_AND_CONSOLE
 } LoggerOption;
 
-// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+/**
+ * How the log file is written
+ */
+typedef enum LoggerFileMode {
+    /**
+     * Through a std::ofstream, under the logger's mutex
+     */
+    BUFFERED_FILE,
+    /**
+     * Each line is written with one pwrite() at an offset reserved atomically, without lock
+     * When a write fails, the rest of its range is filled with spaces and a '\n' and the error is counted
+     * (LoggerStats::writeErrors), so the next lines stay whole
+     * Not available on Windows, where BUFFERED_FILE is used
+     */
+    DIRECT_FILE,
+    /**
+     * Each thread writes the file of its shard (<name>.<shard>.log) with one write(), under the shard's lock only
+     * A line starts with the log number and the monotonic time of its write in nanoseconds, followed by tabs,
+     * the time is taken under the shard's lock so the times of a file are sorted, its numbers may not be
+     * Logger::mergeShards() (or the logger_merge tool) merges the shards in one file ordered by number
+     * Not available on Windows, where BUFFERED_FILE is used
+     */
+    SHARDED_FILE
+} LoggerFileMode;
 
-class Logger {
-private:
+/**
+ * Source of the logs' time
+ */
+typedef enum LoggerClockSource {
     /**
-     * Return the color code
-     * @param color LoggerColor
-     * @return std::string
+     * clock_gettime(CLOCK_REALTIME)
      */
-    static std::string getColor(LoggerColor color);
+    REALTIME_CLOCK,
+    /**
+     * clock_gettime(CLOCK_REALTIME_COARSE), a few milliseconds of resolution but cheaper
+     * REALTIME_CLOCK outside Linux
+     */
+    COARSE_CLOCK,
+    /**
+     * The CPU's time stamp counter, calibrated against CLOCK_REALTIME by init() and resynced every second
+     * Needs an invariant TSC, REALTIME_CLOCK outside x86
+     */
+    TSC_CLOCK
+} LoggerClockSource;
 
+/**
+ * When the written logs are synced to the disk
+ * Not available on Windows, where NO_SYNC is used
+ */
+typedef enum LoggerDurability {
     /**
-     * Return the color code of the log type
-     * @param type LoggerType
-     * @return std::string
+     * Only flushed to the system
      */
-    static std::string getTypeColor(LoggerType type);
+    NO_SYNC,
+    /**
+     * fdatasync() at most once per period, by the log which finds the period elapsed
+     */
+    PERIODIC_SYNC,
+    /**
+     * The log returns once it is on the disk, waiting logs share the same fdatasync()
+     */
+    GROUP_COMMIT
+} LoggerDurability;
 
+/**
+ * Snapshot of the logger's counters, returned by Logger::stats()
+ */
+typedef struct LoggerStats {
     /**
-     * Return the name of the log type
-     * @param type LoggerType
-     * @return std::string
+     * Logs per type, indexed by LoggerType
      */
-    static std::string getTypeName(LoggerType type);
+    uint64_t messages[DEBUG + 1];
+    /**
+     * Bytes written to the log file
+     */
+    uint64_t fileBytes;
+    /**
+     * Bytes written to the console
+     */
+    uint64_t consoleBytes;
+    /**
+     * Bytes written to the additional streams
+     */
+    uint64_t streamBytes;
+    /**
+     * Logs suppressed by a rate limit
+     */
+    uint64_t dropped;
+    /**
+     * Logs suppressed as duplicates
+     */
+    uint64_t suppressed;
+    /**
+     * Logs kept by the flight recorder
+     */
+    uint64_t recorded;
+    /**
+     * Most logs waiting in the flight recorder at once
+     */
+    uint64_t recorderHighWater;
+    /**
+     * Flushes of the log file (one per line in DIRECT_FILE mode)
+     */
+    uint64_t flushes;
+    /**
+     * fdatasync() of the log file
+     */
+    uint64_t syncs;
+    /**
+     * Failed writes, to the log file or to the additional streams
+     */
+    uint64_t writeErrors;
+} LoggerStats;
 
-public:
+/**
+ * Stages of a log measured by the histograms
+ */
+typedef enum LoggerStage {
     /**
-     * Initialisation
+     * Conversion of the arguments to the message
      */
-    static void init(LoggerOption verboseP = FILE_AND_CONSOLE,
-                     const std::vector <LoggerType> &showTypesP = {INFO, SUCCESS, ERROR, WARNING, DEBUG});
+    CAPTURE_STAGE,
+    /**
+     * constructMessage(), once per output
+     */
+    FORMAT_STAGE,
+    /**
+     * Wait for the logger's mutex
+     */
+    LOCK_STAGE,
+    /**
+     * Write and flush of the log file
+     */
+    WRITE_STAGE,
+    /**
+     * Wait until the log is on the disk, PERIODIC_SYNC and GROUP_COMMIT only
+     */
+    SYNC_STAGE
+} LoggerStage;
 
+/**
+ * Latency histogram of a stage, returned by Logger::histograms()
+ * Buckets are log-linear : 8 buckets per power of two, so a value is known within 12.5%
+ */
+typedef struct LoggerHistogram {
     /**
-     * Quit the log and close the writer
+     * Number of buckets
      */
-    static void exit();
+    static const size_t BUCKETS = 496;
 
+    LoggerStage stage;
     /**
-     * Add a new output for the logs
+     * Number of measures
      */
-    static void addOutputStream(std::ostream *os);
+    uint64_t count;
+    /**
+     * Number of measures per bucket
+     */
+    std::vector<uint64_t> buckets;
 
-public:
     /**
-     * Info
-     * @param function std::string
-     * @param option LoggerOption
-     * @param arg const char*
-     * @param ...
+     * Bucket of a value
+     * @param value uint64_t Nanoseconds
+     * @return size_t
      */
-    template<typename... Ts>
-    static void info(const std::string &function, LoggerOption option, Ts const &... args) {
-        genericLog(function, stringify(args...), INFO, option);
-    }
+    static size_t bucketOf(uint64_t value);
 
     /**
-     * Success
-     * @param function std::string
-     * @param option LoggerOption
-     * @param arg const char*
-     * @param ...
+     * Smallest value of a bucket
+     * @param bucket size_t
+     * @return uint64_t Nanoseconds
      */
-    template<typename... Ts>
-    static void success(const std::string &function, LoggerOption option, Ts const &... args) {
-        genericLog(function, stringify(args...), SUCCESS, option);
-    }
+    static uint64_t lowerBound(size_t bucket);
 
     /**
-     * Error
-     * @param function std::string
-     * @param option LoggerOption
-     * @param arg const char*
-     * @param ...
+     * Value under which a part of the measures are
+     * @param p double Part of the measures, in [0, 1]
+     * @return uint64_t Nanoseconds, lower bound of the bucket
      */
-    template<typename... Ts>
-    static void error(const std::string &function, LoggerOption option, Ts const &... args) {
-        genericLog(function, stringify(args...), ERROR, option);
-    }
+    uint64_t percentile(double p) const;
+} LoggerHistogram;
 
+/**
+ * Waits of a call site on the logger's mutex
+ */
+typedef struct LoggerLockSite {
     /**
-     * Warning
-     * @param function std::string
-     * @param option LoggerOption
-     * @param arg const char*
-     * @param ...
+     * Trace of the call site
      */
-    template<typename... Ts>
-    static void warning(const std::string &function, LoggerOption option, Ts const &... args) {
-        genericLog(function, stringify(args...), WARNING, option);
-    }
+    std::string site;
+    /**
+     * Contended acquisitions
+     */
+    uint64_t waits;
+    /**
+     * Nanoseconds spent waiting
+     */
+    uint64_t waitNs;
+} LoggerLockSite;
 
+/**
+ * Snapshot of the logger's mutex profile, returned by Logger::lockStats()
+ * Times are only measured while the profiling is enabled
+ */
+typedef struct LoggerLockStats {
+    uint64_t acquisitions;
     /**
-     * Debug
-     * @param function std::string
-     * @param option LoggerOption
-     * @param arg const char*
-     * @param ...
+     * Acquisitions which found the mutex taken
      */
-    template<typename... Ts>
-    static void debug(const std::string &function, LoggerOption option, Ts const &... args) {
-        genericLog(function, stringify(args...), DEBUG, option);
-    }
+    uint64_t contended;
+    uint64_t waitNs;
+    uint64_t maxWaitNs;
+    uint64_t holdNs;
+    uint64_t maxHoldNs;
+    /**
+     * Call sites sorted by time spent waiting
+     */
+    std::vector<LoggerLockSite> sites;
+} LoggerLockStats;
 
-private:
+/**
+ * An entry of the time index written next to the log file (<log file>.idx), see Logger::setTimeIndex()
+ * The index is the 8 bytes of LOGGER_INDEX_MAGIC followed by the entries, in the byte order of the machine
+ */
+typedef struct LoggerIndexEntry {
     /**
-     * Generic log use for all logs
-     * @param function std::string
-     * @param message std::string
-     * @param type LoggerType
-     * @param option LoggerOption
+     * Time of the log, in nanoseconds since the epoch, raised to the time of the previous entry if it is before
+     */
+    int64_t time;
+    /**
+     * Number of the log
+     */
+    uint64_t number;
+    /**
+     * Offset of the log's first line in the log file
      */
-    static void
-    genericLog(const std::string &function, const std::string &message, LoggerType type, LoggerOption option);
+    uint64_t offset;
+} LoggerIndexEntry;
 
+/**
+ * First bytes of a time index
+ */
+static const char LOGGER_INDEX_MAGIC[8] = {'L', 'O', 'G', 'I', 'D', 'X', '0', '1'};
+
+/**
+ * Configuration of a logger, returned by Logger::getConfig()
+ * Published as an immutable snapshot, the logs read it without lock
+ */
+typedef struct LoggerConfig {
+    std::string consoleFormat;
+    std::string fileFormat;
+    std::string additionalFormat;
     /**
-     * Construct the message from the format
-     * Different rules for the formats :
-     * %Y -> Year
-     * %M -> Month
-     * %D -> Day
-     * %H -> Hour
-     * %m -> Minute
-     * %S -> Second
-     * %N -> Nano second
-     * %d -> Date (%Y-%M-%D@%H-%m-%S)
-     * %h -> Hour (%H:%m:%S:%N)
-     * %T -> Trace
-     * %C -> Content message
-     * %n -> Log number
-     * %t -> Log type
-     *
-     * @param message
-     * @param trace
-     * @param logType
-     * @param format
-     * @return
+     * Directory of the log file, used by the next open()
      */
-    static std::string
-    constructMessage(const std::string &message, const std::string &trace, const std::string &logType,
-                     const std::string &format);
+    std::string logPath;
+    /**
+     * Name of the log file, used by the next open()
+     */
+    std::string projectName;
+    /**
+     * Write the log file as JSON lines instead of fileFormat
+     */
+    bool jsonFile;
+    /**
+     * Escape the control characters and the invalid UTF-8 of the messages in the text outputs
+     */
+    bool sanitize;
+    /**
+     * Repeat the part of the format before %C on each line of a multi-line message
+     */
+    bool multiline;
+    /**
+     * Id of each %X{key} of the formats, in order, set by the logger when the configuration is published
+     */
+    std::vector<size_t> consoleKeys;
+    std::vector<size_t> fileKeys;
+    std::vector<size_t> additionalKeys;
+} LoggerConfig;
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+/**
+ * Mutex of the synchronous write path
+ *
+ * A futex lock (a yield loop outside Linux) which counts its acquisitions and, when profiled,
+ * the time waited and held and the call sites which wait.
+ * It can spin before sleeping, the number of spins adapts to the length of the critical section.
+ */
+class LoggerMutex {
+public:
+    LoggerMutex();
 
     /**
-     * Write the log into the file
-     * @param message std::string
+     * @param site const char* Trace of the caller, for the profile
      */
-    static void writeToFile(const std::string &message);
+    void lock(const char *site);
+
+    void unlock();
 
     /**
-     * The log's hour
-     * hh:mm:ss:nnn
-     * @return std::string
+     * Measure the waits and the holds
+     * @param enabled bool
      */
-    static std::string getHour();
+    void setProfiling(bool enabled);
 
     /**
-     * The log's date
-     * yyyy-mm-dd@hh-mm-ss
-     * @return std::string
+     * Spin before sleeping when the mutex is taken
+     * @param enabled bool
+     */
+    void setSpinning(bool enabled);
+
+    /**
+     * Snapshot of the profile
+     * @return LoggerLockStats
      */
-    static std::string getDate();
+    LoggerLockStats stats() const;
 
 private:
     /**
-     * If the logger is initialized
+     * Sleep until the state may have changed
+     * @param expected int
      */
-    static bool isInitialized;
+    void wait(int expected);
+
     /**
-     * The log file
+     * Wake a waiting thread
      */
-    static std::ofstream file;
+    void wake();
+
     /**
-     * Additional output for the logs
+     * Add a wait to the call site's entry
+     * @param site const char*
+     * @param waitNs uint64_t
      */
-    static std::vector<std::ostream *> additionalStreams;
+    void recordSite(const char *site, uint64_t waitNs);
+
     /**
-     * The number of log
+     * 0 free, 1 taken, 2 taken with waiting threads
      */
-    static int nbLog;
+    std::atomic<int> state;
+    std::atomic<bool> profiling;
+    std::atomic<bool> spinning;
     /**
-     * A mutex for writeToFile(), to be thread-safe
+     * Current number of spins, adapted after each contended acquisition
      */
-    static pthread_mutex_t mutex;
+    std::atomic<unsigned> spinLimit;
+
+    /*
+     * The counters are only written by the owner of the mutex, so without read-modify-write
+     */
+    std::atomic<uint64_t> acquisitions;
+    std::atomic<uint64_t> contended;
+    std::atomic<uint64_t> waitNs;
+    std::atomic<uint64_t> maxWaitNs;
+    std::atomic<uint64_t> holdNs;
+    std::atomic<uint64_t> maxHoldNs;
     /**
-     * The type of verbose
+     * When the owner took the mutex, 0 if not profiled
      */
-    static LoggerOption verbose;
+    int64_t holdStart;
+
     /**
-     * The types of logs that be shown
+     * Waits of a call site, claimed by the hash of its trace
      */
-    static std::vector <LoggerType> showTypes;
+    struct Site {
+        std::atomic<uint64_t> hash;
+        std::atomic<bool> ready;
+        char name[64];
+        std::atomic<uint64_t> waits;
+        std::atomic<uint64_t> waitNs;
+    };
 
-private: // Disallow to instance this class
-    Logger() = default;
+    /**
+     * Number of call sites kept
+     */
+    static const size_t SITES = 64;
+    Site sites[SITES];
+};
 
-    ~Logger() = default;
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
 
-private: // Methods used for variadic functions
-    template<typename... Ts>
-    static std::string stringify(Ts const &... vals) {
-        std::string res;
+class Logger;
 
-        /*
-         * Fill unused array with count(vals)+1 0
-         * The syntax (A,B) affect B value to array, but also do A due to comma operator
-         */
-        int unused[] = {0, (res += toString(vals), 0)...};
+/**
+ * Rate limiter and duplicate suppressor of one call site
+ * Created by the *_LOG_LIMITED macros, one per call site
+ *
+ * The rate limit is a token bucket (GCRA) stored in a single atomic, checked
+ * first so a suppressed line is neither formatted nor hashed.
+ * Identical consecutive messages of the call site, compared on a hash of their
+ * arguments, are collapsed in a 'Last message repeated N times' line, written before
+ * the next different message or once per token interval (once per second without
+ * rate limit) while they repeat.
+ */
+class LoggerLimiter {
+public:
+    /**
+     * @param function const char* Trace of the call site
+     * @param type LoggerType
+     * @param option LoggerOption
+     * @param perSecond double Lines allowed per second, <= 0 for no rate limit
+     * @param burst unsigned Lines allowed at once
+     */
+    LoggerLimiter(const char *function, LoggerType type, LoggerOption option, double perSecond, unsigned burst);
 
-        return res;
-    }
+    /**
+     * Take a token from the bucket
+     * @return bool False if the line must be suppressed
+     */
+    bool acquire();
 
-    template<typename T>
-    static typename std::enable_if<false == std::is_convertible<T, std::string>::value, std::string>::type
-    toString(T const &val) {
-        return std::to_string(val);
-    }
+    /**
+     * Check the message against the last one written by the call site
+     * @param hash uint64_t Hash of the arguments of the message, never 0
+     * @return bool True if the message is a duplicate and must be suppressed
+     */
+    bool isDuplicate(uint64_t hash);
 
-    static std::string toString(std::string const &val) {
-        return val;
-    }
-};
+    /**
+     * If the count of the duplicates must be written now, once per period while a message repeats
+     * @return bool
+     */
+    bool summaryDue();
+
+private:
+    friend class Logger;
+
+    /**
+     * Forget the last message, the next one is never a duplicate
+     */
+    void forget();
+
+    /**
+     * Logger of the last line written, which gets the pending counts
+     * nullptr once it is closed or destroyed, so a limiter never points to a freed logger
+     */
+    std::atomic<Logger *> owner;
+    /**
+     * Trace of the call site
+     */
+    const char *function;
+    /**
+     * Log type of the call site
+     */
+    LoggerType type;
+    /**
+     * Log option of the call site
+     */
+    LoggerOption option;
+    /**
+     * Nanoseconds between two tokens
+     */
+    int64_t interval;
+    /**
+     * Nanoseconds of advance allowed on the theoretical arrival time
+     */
+    int64_t tolerance;
+    /**
+     * Nanoseconds between two 'repeated' lines of a message which keeps repeating
+     */
+    int64_t summaryPeriod;
+    /**
+     * Theoretical arrival time of the next token (monotonic nanoseconds)
+     */
+    std::atomic<int64_t> tat;
+    /**
+     * Hash of the arguments of the last message written, 0 for none
+     */
+    std::atomic<uint64_t> lastHash;
+    /**
+     * Time of the last 'repeated' line or of the last different message (monotonic nanoseconds)
+     */
+    std::atomic<int64_t> lastSummary;
+    /**
+     * Number of duplicates since the last message
+     */
+    std::atomic<uint64_t> repeated;
+    /**
+     * Number of lines suppressed by the rate limit
+     */
+    std::atomic<uint64_t> dropped;
+    /**
+     * Next limiter in the registry
+     */
+    LoggerLimiter *next;
+
+    /**
+     * Registry of all limiters, flushed by the close() of their owner
+     */
+    static std::atomic<LoggerLimiter *> head;
+};
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+/**
+ * Types enabled for the module of a call site
+ * Created by the *_LOG_MODULE macros, one per call site
+ *
+ * The types of the module are resolved once, from the module or its nearest parent, and cached
+ * with the generation of the modules' configuration. A call site only resolves them again
+ * after Logger::setModuleTypes() or Logger::resetModuleTypes() changed the generation.
+ */
+class LoggerModuleSite {
+public:
+    /**
+     * @param module const char* Name of the module, its parents are separated by dots ("net.http")
+     */
+    explicit LoggerModuleSite(const char *module);
+
+    /**
+     * If the type is enabled for the module
+     * @param type LoggerType
+     * @return bool
+     */
+    bool isEnabled(LoggerType type) {
+        uint64_t c = cached.load(std::memory_order_relaxed);
+        if ((c >> 8) != generation.load(std::memory_order_relaxed))
+            c = refresh();
+
+        return (c >> type & 1) != 0;
+    }
+
+private:
+    friend class Logger;
+
+    /**
+     * Resolve the types of the module and cache them
+     * @return uint64_t The new cached value
+     */
+    uint64_t refresh();
+
+    /**
+     * Name of the module
+     */
+    const char *module;
+    /**
+     * Generation in the high bits, one bit per enabled LoggerType in the low 8 bits
+     */
+    std::atomic<uint64_t> cached;
+
+    /**
+     * Generation of the modules' configuration, starts at 1 so a new call site resolves its types
+     */
+    static std::atomic<uint64_t> generation;
+};
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+/**
+ * A DEBUG_LOG call site, which can be disabled at runtime
+ * Created by DEBUG_LOG, DEBUG_KV and their _TO variants, one per call site, and registered on its first call
+ *
+ * Sites are matched by their function or their 'file:line' with a glob (* and ?),
+ * see Logger::enableSites(). A rule also applies to the sites registered after it.
+ */
+class LoggerSite {
+public:
+    /**
+     * @param function const char*
+     * @param file const char*
+     * @param line int
+     */
+    LoggerSite(const char *function, const char *file, int line);
+
+    /**
+     * If the call site writes its logs
+     * @return bool
+     */
+    bool isEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+private:
+    friend class Logger;
+
+    /**
+     * If the site matches a glob, on its function or on its "file:line", without allocating
+     * @param pattern std::string
+     * @return bool
+     */
+    bool matches(const std::string &pattern) const;
+
+    const char *function;
+    const char *file;
+    int line;
+    std::atomic<bool> enabled;
+    /**
+     * Next site in the registry
+     */
+    LoggerSite *next;
+
+    /**
+     * Registry of all the sites
+     */
+    static std::atomic<LoggerSite *> head;
+};
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+/**
+ * A timed span of code, from its construction to its destruction
+ * Created by LOG_SCOPE_TIMER, one per scope
+ *
+ * The span reads the logger's clock at both ends. When it ends, it writes its duration as a DEBUG log
+ * and, if the logger traces, a complete event in the trace file (see Logger::openTrace()).
+ * A trace-only span, created by LOG_SCOPE_TRACE, writes no log and does nothing more when the logger does not trace.
+ * Spans nested in the same thread carry their depth.
+ */
+class LoggerSpan {
+public:
+    /**
+     * @param logger Logger
+     * @param option LoggerOption Outputs of the DEBUG log
+     * @param name const char* Name of the span, must live until the end of the span
+     * @param function const char* Trace of the span
+     */
+    LoggerSpan(Logger &logger, LoggerOption option, const char *name, const char *function);
+
+    /**
+     * A trace-only span, without DEBUG log
+     * @param logger Logger
+     * @param name const char* Name of the span, must live until the end of the span
+     * @param function const char* Trace of the span
+     */
+    LoggerSpan(Logger &logger, const char *name, const char *function);
+
+    ~LoggerSpan();
+
+    LoggerSpan(const LoggerSpan &) = delete;
+
+    LoggerSpan &operator=(const LoggerSpan &) = delete;
+
+private:
+    friend class Logger;
+
+    Logger *logger;
+    LoggerOption option;
+    /**
+     * If the span writes its DEBUG log, false for a trace-only span
+     */
+    bool logged;
+    const char *name;
+    const char *function;
+    /**
+     * clockStamp() at the start of the span
+     */
+    uint64_t start;
+    /**
+     * Number of spans of the thread around this one
+     */
+    unsigned depth;
+
+    /**
+     * Number of spans open in the thread
+     */
+    static thread_local unsigned openSpans;
+};
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+class Logger {
+private:
+    /**
+     * Return the color code
+     * @param color LoggerColor
+     * @return std::string
+     */
+    static std::string getColor(LoggerColor color);
+
+    /**
+     * Return the color code of the log type
+     * @param type LoggerType
+     * @return std::string
+     */
+    static std::string getTypeColor(LoggerType type);
+
+    /**
+     * Return the name of the log type
+     * @param type LoggerType
+     * @return std::string
+     */
+    static std::string getTypeName(LoggerType type);
+
+public:
+    /**
+     * A logger with its own file, formats, types, mutex and counters
+     * Its file is LOG_PATH/PROJECT_NAME_log_<date>.log, give another name to each logger of the same directory
+     * @param projectName std::string
+     * @param logPath std::string
+     */
+    explicit Logger(const std::string &projectName = PROJECT_NAME, const std::string &logPath = LOG_PATH);
+
+    /**
+     * Close the logger if it is open
+     */
+    ~Logger();
+
+    Logger(const Logger &) = delete;
+
+    Logger &operator=(const Logger &) = delete;
+
+    /**
+     * Allocate a logger on the heap, aligned on its cache line counters even before C++17
+     * @param size size_t
+     * @return void *
+     */
+    static void *operator new(size_t size);
+
+    /**
+     * Build a logger in the given storage, which must be aligned as alignof(Logger)
+     * @param size size_t
+     * @param place void *
+     * @return void *
+     */
+    static void *operator new(size_t size, void *place) noexcept {
+        (void) size;
+        return place;
+    }
+
+    /**
+     * Free a logger allocated on the heap
+     * @param pointer void *
+     */
+    static void operator delete(void *pointer) noexcept;
+
+    /**
+     * The default logger, used by the macros and by the static functions
+     * Never destroyed, so it can be used until the end of the process
+     * @return Logger
+     */
+    static Logger &global();
+
+    /**
+     * Initialisation of the default logger
+     */
+    static void init(LoggerOption verboseP = FILE_AND_CONSOLE,
+                     const std::vector <LoggerType> &showTypesP = {INFO, SUCCESS, ERROR, WARNING, DEBUG});
+
+    /**
+     * Quit the default logger and close its writer
+     */
+    static void exit();
+
+    /**
+     * Add a new output for the logs of the default logger
+     */
+    static void addOutputStream(std::ostream *os);
+
+    /**
+     * Open the log file and start logging
+     * @param verboseP LoggerOption
+     * @param showTypesP std::vector<LoggerType> Types shown in the console
+     */
+    void open(LoggerOption verboseP = FILE_AND_CONSOLE,
+              const std::vector <LoggerType> &showTypesP = {INFO, SUCCESS, ERROR, WARNING, DEBUG});
+
+    /**
+     * Stop logging and close the log file
+     */
+    void close();
+
+    /**
+     * Add a new output for the logs
+     * @param os std::ostream
+     */
+    void addStream(std::ostream *os);
+
+    /**
+     * Write the spans in a Chrome trace file (trace_event JSON), which chrome://tracing
+     * and Perfetto open, until closeTrace()
+     * @param path std::string Replaced if it exists
+     * @return bool False if the file cannot be created
+     */
+    bool openTrace(const std::string &path);
+
+    /**
+     * Finish and close the trace file
+     */
+    void closeTrace();
+
+    /**
+     * Change the formats of the logger, the next logs use them
+     * @param consoleFormat std::string
+     * @param fileFormat std::string
+     * @param additionalFormat std::string
+     */
+    void setFormats(const std::string &consoleFormat, const std::string &fileFormat,
+                    const std::string &additionalFormat);
+
+    /**
+     * Write the log file as JSON lines, the next logs use it
+     * @param enabled bool
+     */
+    void setJsonFile(bool enabled);
+
+    /**
+     * Escape the control characters and the invalid UTF-8 of the messages in the text outputs,
+     * so a message is one line and cannot change the colors of the console
+     * @param enabled bool
+     */
+    void setSanitize(bool enabled);
+
+    /**
+     * Repeat the prefix of the format (the part before %C) on each line of a multi-line message,
+     * so a stack trace or a dump stays attributed to its log
+     * The sanitization escapes the newlines first
+     * @param enabled bool
+     */
+    void setMultiline(bool enabled);
+
+    /**
+     * Set a field of the calling thread's context, shared by all the loggers
+     * The field is written by %X{key} and %X in the formats, and after the fields in the JSON file
+     * The context is rendered here, a log only copies it
+     * @param key std::string
+     * @param value std::string
+     */
+    static void setContext(const std::string &key, const std::string &value);
+
+    /**
+     * Remove a field of the calling thread's context
+     * @param key std::string
+     */
+    static void removeContext(const std::string &key);
+
+    /**
+     * Remove all the fields of the calling thread's context, at the end of a request
+     */
+    static void clearContext();
+
+    /**
+     * Name the calling thread, written by %I (also given to the system, which may truncate it)
+     * Without it, %I is the system's name of the thread, read once
+     * @param name std::string
+     */
+    static void setThreadName(const std::string &name);
+
+    /**
+     * Snapshot of the configuration
+     * @return LoggerConfig
+     */
+    LoggerConfig getConfig();
+
+    /**
+     * Read the configuration from a file, the keys not in the file are kept
+     * One 'key = value' per line, '#' starts a comment, \t \n and \\ are unescaped in the values
+     * Keys : console_format, file_format, additional_format, log_path, project_name, json_file and sanitize (true or false)
+     * @param path std::string
+     * @return bool False if the file cannot be read
+     */
+    bool loadConfig(const std::string &path);
+
+    /**
+     * Load the configuration file, then again each time it is written or replaced
+     * The file is watched with inotify by a thread, outside Linux it is only loaded
+     * @param path std::string
+     */
+    void watchConfig(const std::string &path);
+
+    /**
+     * Stop watching the configuration file
+     */
+    void unwatchConfig();
+
+    /**
+     * Snapshot of the counters since the creation of the logger
+     * The counters are sharded per thread and summed here
+     * @return LoggerStats
+     */
+    LoggerStats stats() const;
+
+    /**
+     * Measure the waits and holds of the logger's mutex and the call sites which wait
+     * The acquisitions are always counted
+     * @param enabled bool
+     */
+    void setLockProfiling(bool enabled);
+
+    /**
+     * Spin before sleeping on the logger's mutex, for short critical sections on several cores
+     * @param enabled bool
+     */
+    void setLockSpinning(bool enabled);
+
+    /**
+     * Snapshot of the logger's mutex profile
+     * @return LoggerLockStats
+     */
+    LoggerLockStats lockStats() const;
+
+    /**
+     * Write the mutex profile and the call sites which waited the most
+     * @param os std::ostream
+     * @param top size_t Number of call sites written
+     */
+    void exportLockProfile(std::ostream &os, size_t top = 10) const;
+
+    /**
+     * Start measuring the latency of each stage of the logs
+     * Without it, the logs do not read the clock for the histograms
+     */
+    void enableHistograms();
+
+    /**
+     * Stop measuring the latencies, the histograms are kept
+     */
+    void disableHistograms();
+
+    /**
+     * Snapshot of the histograms, indexed by LoggerStage
+     * @return std::vector<LoggerHistogram>
+     */
+    std::vector<LoggerHistogram> histograms() const;
+
+    /**
+     * Write the histograms, one JSON object per stage and per line
+     * {"stage": "format", "count": 12, "p50": 1024, "p90": 1152, "p99": 2048, "p999": 2048, "max": 2048,
+     *  "buckets": [[1024, 10], [1152, 1], [2048, 1]]}
+     * Values are in nanoseconds, each bucket is given by its lower bound
+     * @param os std::ostream
+     */
+    void exportHistograms(std::ostream &os) const;
+
+    /**
+     * Choose the source of the logs' time, for all the loggers
+     * Call it before starting to log from several threads
+     * @param source LoggerClockSource
+     */
+    static void setClock(LoggerClockSource source);
+
+    /**
+     * Choose how the log file is written
+     * Call it before open()
+     * @param mode LoggerFileMode
+     */
+    void setFileMode(LoggerFileMode mode);
+
+    /**
+     * Number of files of SHARDED_FILE, the threads are spread over them
+     * A shard's file is created by its first log
+     * Call it before open()
+     * @param count unsigned Between 1 and 64
+     */
+    void setFileShards(unsigned count);
+
+    /**
+     * Write a sparse time index next to the log file (<log file>.idx) : an entry each time
+     * the file grew by the interval, for the first log after it
+     * The logger_query tool searches it to read a range of time without reading the whole file
+     * Only for BUFFERED_FILE and DIRECT_FILE, not available on Windows
+     * Call it before open()
+     * @param intervalKb unsigned Kilobytes between two entries, 0 to disable the index
+     */
+    void setTimeIndex(unsigned intervalKb);
+
+    /**
+     * Merge the files of SHARDED_FILE in one stream ordered by log number, without their number and time
+     * The files are merged by time, then the logs are reordered by number within the window : a log is written
+     * once no log read later may have a smaller number, unless it waited more than the window to be written
+     * The lines which do not start with a number and a time belong to the log before them
+     * @param paths std::vector<std::string> Files of the shards
+     * @param out std::ostream
+     * @param windowNs int64_t Longest time between the number and the write of a log, in nanoseconds
+     * @return bool False if a file cannot be read
+     */
+    static bool mergeShards(const std::vector<std::string> &paths, std::ostream &out,
+                            int64_t windowNs = 1000000000);
+
+    /**
+     * Choose when the logs of some types are synced to the disk
+     * @param durabilityP LoggerDurability
+     * @param types std::vector<LoggerType> Types using this durability
+     * @param periodMs unsigned Period of PERIODIC_SYNC, in milliseconds
+     */
+    void setDurability(LoggerDurability durabilityP,
+                       const std::vector <LoggerType> &types = {INFO, SUCCESS, ERROR, WARNING, DEBUG},
+                       unsigned periodMs = 1000);
+
+    /**
+     * Enable the flight recorder
+     * Logs of the recorded types are kept in memory instead of being written,
+     * the last ones are written to the file when an error is logged or on dumpFlightRecorder()
+     * It can be called while other threads log, it replaces the previous recorder and its logs
+     * @param capacity size_t Number of logs kept
+     * @param types std::vector<LoggerType> Types kept in memory
+     */
+    void enableFlightRecorder(size_t capacity, const std::vector <LoggerType> &types = {INFO, DEBUG});
+
+    /**
+     * Disable the flight recorder, the recorded logs are lost
+     */
+    void disableFlightRecorder();
+
+    /**
+     * Write the recorded logs to the file
+     */
+    void dumpFlightRecorder();
+
+    /**
+     * Dump the flight recorders of all the loggers when the signal is received
+     * The dump is done by the next log or by close(), not in the handler
+     * @param signal int
+     */
+    static void dumpFlightRecorderOnSignal(int signal);
+
+    /**
+     * Choose the types logged by a module and its children without their own types
+     * "net" applies to "net.http" and "net.tcp", the types of "" apply to all modules
+     * @param module std::string
+     * @param types std::vector<LoggerType>
+     */
+    static void setModuleTypes(const std::string &module, const std::vector <LoggerType> &types);
+
+    /**
+     * Enable the DEBUG_LOG sites matching the glob, by function or 'file:line'
+     * "parse*", "*net*.cpp:*", "*main.cpp:42"
+     * @param pattern std::string
+     * @return size_t Number of registered sites matched
+     */
+    static size_t enableSites(const std::string &pattern);
+
+    /**
+     * Disable the DEBUG_LOG sites matching the glob, by function or 'file:line'
+     * A disabled site does not evaluate its arguments
+     * @param pattern std::string
+     * @return size_t Number of registered sites matched
+     */
+    static size_t disableSites(const std::string &pattern);
+
+    /**
+     * Write the registered DEBUG_LOG sites matching the glob, one per line : 'file:line function +' (- if disabled)
+     * @param os std::ostream
+     * @param pattern std::string
+     */
+    static void listSites(std::ostream &os, const std::string &pattern = "*");
+
+    /**
+     * Control the DEBUG_LOG sites from a Unix socket, one command per line :
+     * '+pattern' enables, '-pattern' disables, the answer is the number of sites matched
+     * '?pattern' lists the sites like listSites()
+     * The socket is only accessible by the user of the process
+     * Not available on Windows
+     * @param path std::string Path of the socket, replaced if it is a socket
+     * @return bool False if the socket cannot be created or if the path exists and is not a socket
+     */
+    static bool openSiteControl(const std::string &path);
+
+    /**
+     * Close the socket of openSiteControl()
+     */
+    static void closeSiteControl();
+
+    /**
+     * The module inherits the types of its parent again
+     * @param module std::string
+     */
+    static void resetModuleTypes(const std::string &module);
+
+    /**
+     * Types logged by a module, its own or inherited
+     * @param module std::string
+     * @return std::vector<LoggerType>
+     */
+    static std::vector<LoggerType> getModuleTypes(const std::string &module);
+
+public:
+    /**
+     * Info
+     * @param function std::string
+     * @param option LoggerOption
+     * @param arg const char*
+     * @param ...
+     */
+    template<typename... Ts>
+    void info(const std::string &function, LoggerOption option, Ts const &... args) {
+        genericLog(function, capture(args...), INFO, option);
+    }
+
+    /**
+     * Success
+     * @param function std::string
+     * @param option LoggerOption
+     * @param arg const char*
+     * @param ...
+     */
+    template<typename... Ts>
+    void success(const std::string &function, LoggerOption option, Ts const &... args) {
+        genericLog(function, capture(args...), SUCCESS, option);
+    }
+
+    /**
+     * Error
+     * @param function std::string
+     * @param option LoggerOption
+     * @param arg const char*
+     * @param ...
+     */
+    template<typename... Ts>
+    void error(const std::string &function, LoggerOption option, Ts const &... args) {
+        genericLog(function, capture(args...), ERROR, option);
+    }
+
+    /**
+     * Warning
+     * @param function std::string
+     * @param option LoggerOption
+     * @param arg const char*
+     * @param ...
+     */
+    template<typename... Ts>
+    void warning(const std::string &function, LoggerOption option, Ts const &... args) {
+        genericLog(function, capture(args...), WARNING, option);
+    }
+
+    /**
+     * Debug
+     * @param function std::string
+     * @param option LoggerOption
+     * @param arg const char*
+     * @param ...
+     */
+    template<typename... Ts>
+    void debug(const std::string &function, LoggerOption option, Ts const &... args) {
+        genericLog(function, capture(args...), DEBUG, option);
+    }
+
+    /**
+     * Structured log, the fields are keys followed by their value
+     * The text outputs get 'message key=value...', the JSON file gets one member per field
+     * with its type : strings are escaped, numbers and booleans are written as is
+     * @param type LoggerType
+     * @param function std::string
+     * @param option LoggerOption
+     * @param message std::string
+     * @param key const char*
+     * @param value std::string, const char*, bool, integer or floating point
+     * @param ...
+     */
+    template<typename... Ts>
+    void kv(LoggerType type, const std::string &function, LoggerOption option, const std::string &message,
+            Ts const &... fields) {
+        int64_t start = histogramsEnabled.load(std::memory_order_acquire) ? monotonicNow() : 0;
+        // Reused by the thread, no allocation once the buffers are large enough
+        static thread_local Fields buffers;
+        buffers.text.clear();
+        buffers.json.clear();
+        appendFields(buffers, fields...);
+        if (start != 0)
+            measure(CAPTURE_STAGE, start);
+
+        genericLog(function, message, type, option, &buffers);
+    }
+
+    /**
+     * Draw from the thread-local generator
+     * @param ratio double Probability to return true, in [0, 1]
+     * @return bool
+     */
+    static bool sample(double ratio) {
+        // xorshift64*, one per thread so no shared cache line is written
+        static thread_local uint64_t state = 0;
+        if (state == 0)
+            state = ((uint64_t) (uintptr_t) &state ^ (uint64_t) monotonicNow()) * 0x9E3779B97F4A7C15ULL | 1;
+
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+
+        return (double) ((state * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0 < ratio;
+    }
+
+    /**
+     * Log through the limiter of a call site
+     * @param limiter LoggerLimiter
+     * @param arg const char*
+     * @param ...
+     */
+    template<typename... Ts>
+    void limited(LoggerLimiter &limiter, Ts const &... args) {
+        // The bucket first, a suppressed line is never formatted
+        if (!limiter.acquire()) {
+            counters().dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        if (limiter.owner.load(std::memory_order_acquire) != this)
+            adoptLimiter(limiter);
+
+        if (limiter.isDuplicate(hashArgs(args...))) {
+            counters().suppressed.fetch_add(1, std::memory_order_relaxed);
+            if (limiter.summaryDue())
+                flushLimiter(limiter);
+            return;
+        }
+
+        flushLimiter(limiter);
+        genericLog(limiter.function, capture(args...), limiter.type, limiter.option);
+    }
+
+private:
+    /**
+     * Fields of a structured log, rendered once for both kinds of outputs
+     */
+    struct Fields {
+        /**
+         * ' key=value' for each field
+         */
+        std::string text;
+        /**
+         * ',"key":value' for each field
+         */
+        std::string json;
+    };
+
+    /**
+     * Diagnostic context of a thread, rendered when it changes so the logs only copy it
+     * Immutable once set, the flight recorder keeps the one of each log
+     */
+    struct Context {
+        std::vector<std::pair<std::string, std::string>> fields;
+        /**
+         * Value of each field by the id of its key, empty for the keys it does not have, copied by %X{key}
+         */
+        std::vector<std::string> values;
+        /**
+         * 'key=value' for each field, separated by spaces
+         */
+        std::string text;
+        /**
+         * ',"key":"value"' for each field
+         */
+        std::string json;
+    };
+
+    /**
+     * Context of the calling thread, nullptr when it is empty
+     * @return std::shared_ptr<const Context>
+     */
+    static std::shared_ptr<const Context> &threadContext();
+
+    /**
+     * Render the text and the JSON of a context
+     * @param context Context
+     */
+    static void renderContext(Context &context);
+
+    /**
+     * Id of a key of the contexts, registered on its first use
+     * @param key std::string
+     * @return size_t
+     */
+    static size_t contextKeyId(const std::string &key);
+
+    /**
+     * Find the next %X{key} of a format, read as constructMessage() reads it
+     * @param format std::string
+     * @param from size_t Position where the search starts, moved after the key
+     * @param key std::string Set to the key
+     * @return bool False when the format has no more key
+     */
+    static bool nextFormatKey(const std::string &format, size_t &from, std::string &key);
+
+    /**
+     * Ids of the %X{key} of a format, in order
+     * @param format std::string
+     * @return std::vector<size_t>
+     */
+    static std::vector<size_t> formatKeys(const std::string &format);
+
+    /**
+     * Set the ids of the %X{key} of the formats of a configuration
+     * @param configuration LoggerConfig
+     * @return LoggerConfig The configuration
+     */
+    static LoggerConfig *compileFormats(LoggerConfig *configuration);
+
+    /**
+     * Id and name of a thread, rendered once per thread for %i and %I
+     */
+    struct Thread {
+        std::string id;
+        std::string name;
+    };
+
+    /**
+     * A flight recorder and its ring, defined with the logger's members
+     */
+    struct FlightRecorder;
+
+    /**
+     * A file of SHARDED_FILE mode, defined with the logger's members
+     */
+    struct alignas(64) FileShard;
+
+    /**
+     * The calling thread, its name is read on its first log
+     * @return Thread
+     */
+    static Thread &currentThread();
+
+    static void appendFields(Fields &) {}
+
+    template<typename V, typename... Ts>
+    static void appendFields(Fields &fields, const char *key, const V &value, Ts const &... rest) {
+        fields.text += ' ';
+        fields.text += key;
+        fields.text += '=';
+        fields.json += ',';
+        appendJsonString(fields.json, key, strlen(key));
+        fields.json += ':';
+        appendValue(fields, value);
+        appendFields(fields, rest...);
+    }
+
+    static void appendValue(Fields &fields, const std::string &value) {
+        fields.text += value;
+        appendJsonString(fields.json, value.data(), value.length());
+    }
+
+    static void appendValue(Fields &fields, const char *value) {
+        fields.text += value;
+        appendJsonString(fields.json, value, strlen(value));
+    }
+
+    static void appendValue(Fields &fields, bool value) {
+        fields.text += value ? "true" : "false";
+        fields.json += value ? "true" : "false";
+    }
+
+    template<typename V>
+    static typename std::enable_if<std::is_integral<V>::value>::type appendValue(Fields &fields, V value) {
+        char buffer[24];
+        char *end = buffer + sizeof(buffer);
+        char *p = end;
+        // Through the unsigned type so the smallest value does not overflow
+        typename std::make_unsigned<V>::type n = value < 0 ? 0 - (typename std::make_unsigned<V>::type) value
+                                                           : (typename std::make_unsigned<V>::type) value;
+        do {
+            *--p = (char) ('0' + n % 10);
+            n /= 10;
+        } while (n != 0);
+        if (value < 0)
+            *--p = '-';
+        fields.text.append(p, (size_t) (end - p));
+        fields.json.append(p, (size_t) (end - p));
+    }
+
+    template<typename V>
+    static typename std::enable_if<std::is_floating_point<V>::value>::type appendValue(Fields &fields, V value) {
+        char buffer[32];
+        int n = snprintf(buffer, sizeof(buffer), "%.15g", (double) value);
+        fields.text.append(buffer, (size_t) n);
+        // JSON has no NaN nor infinity
+        if (value == value && value - value == 0)
+            fields.json.append(buffer, (size_t) n);
+        else
+            appendJsonString(fields.json, buffer, (size_t) n);
+    }
+
+    /**
+     * Append a JSON string, quoted and escaped
+     * @param out std::string
+     * @param data const char*
+     * @param length size_t
+     */
+    static void appendJsonString(std::string &out, const char *data, size_t length);
+
+    /**
+     * Append the data, escaped for JSON or sanitized for the text outputs
+     * JSON : '"', '\\' and the control characters are escaped, invalid UTF-8 becomes \ufffd
+     * Text : the control characters and DEL become \n, \t, \r or \xNN, invalid UTF-8 becomes \xNN
+     * @param out std::string
+     * @param data const char*
+     * @param length size_t
+     * @param json bool
+     */
+    static void escape(std::string &out, const char *data, size_t length, bool json);
+
+    /**
+     * Position of the first byte which needs an escape : control characters, invalid UTF-8,
+     * '"' and '\\' for JSON, DEL for text
+     * Scans 32 (AVX2) or 16 (SSE2) bytes at once when the CPU has them, valid UTF-8 sequences are skipped
+     * @param data const char*
+     * @param length size_t
+     * @param json bool
+     * @return size_t length if no byte needs an escape
+     */
+    static size_t findEscape(const char *data, size_t length, bool json);
+
+    /**
+     * Sanitize a message and its fields, the final '\n' is kept
+     * @param t std::string
+     */
+    static void sanitizeMessage(std::string &t);
+
+    /**
+     * Convert the arguments to the message, measured by the CAPTURE_STAGE histogram
+     * The message is built in a buffer of the thread, which keeps its capacity between the logs
+     * @param arg const char*
+     * @param ...
+     * @return std::string Valid until the next capture() of the thread
+     */
+    template<typename... Ts>
+    const std::string &capture(Ts const &... args) {
+        std::string &res = captureBuffer();
+        res.clear();
+        if (!histogramsEnabled.load(std::memory_order_acquire)) {
+            stringifyTo(res, args...);
+            return res;
+        }
+
+        int64_t start = monotonicNow();
+        stringifyTo(res, args...);
+        measure(CAPTURE_STAGE, start);
+
+        return res;
+    }
+
+    /**
+     * The buffer of capture(), one per thread
+     * @return std::string
+     */
+    static std::string &captureBuffer();
+
+    /**
+     * Add the time elapsed since start to the histogram of a stage
+     * @param stage LoggerStage
+     * @param start int64_t monotonicNow() at the start of the stage
+     */
+    void measure(LoggerStage stage, int64_t start);
+
+    /**
+     * Name of a stage
+     * @param stage LoggerStage
+     * @return std::string
+     */
+    static std::string getStageName(LoggerStage stage);
+
+    /**
+     * Generic log use for all logs
+     * @param function std::string
+     * @param message std::string
+     * @param type LoggerType
+     * @param option LoggerOption
+     * @param fields Fields Fields of a structured log, nullptr for the others
+     */
+    void genericLog(const std::string &function, const std::string &message, LoggerType type, LoggerOption option,
+                    const Fields *fields = nullptr);
+
+    /**
+     * Construct the JSON line of the log file
+     * {"seq": %n, "time": "%Y-%M-%DT%H:%m:%S.%N", "level": %t, "trace": %T, "message": %C, fields..., context...}
+     * @param message std::string Without the fields, a final '\n' is not written
+     * @param trace std::string
+     * @param type LoggerType
+     * @param now Time of the log
+     * @param number Log number
+     * @param fields Fields nullptr if the log is not structured
+     * @param context Context Written after the fields, nullptr if the thread has none
+     * @return std::string A buffer of the thread, valid until its next call
+     */
+    const std::string &constructJson(const std::string &message, const std::string &trace, LoggerType type,
+                                     const struct timespec &now, uint64_t number, const Fields *fields,
+                                     const Context *context);
+
+    /**
+     * Construct the message from the format
+     * Different rules for the formats :
+     * %Y -> Year
+     * %M -> Month
+     * %D -> Day
+     * %H -> Hour
+     * %m -> Minute
+     * %S -> Second
+     * %N -> Nano second
+     * %d -> Date (%Y-%M-%D@%H-%m-%S)
+     * %h -> Hour (%H:%m:%S:%N)
+     * %T -> Trace
+     * %C -> Content message
+     * %n -> Log number
+     * %t -> Log type
+     * %i -> Thread id
+     * %I -> Thread name
+     * %X{key} -> Value of the key in the context
+     * %X -> The whole context
+     *
+     * @param message
+     * @param trace
+     * @param logType
+     * @param format
+     * @param keys size_t Id of each %X{key} of the format, see formatKeys()
+     * @param now Time of the log
+     * @param number Log number
+     * @param context Context Context of the log's thread, nullptr if it has none
+     * @param thread Thread The log's thread, nullptr if unknown
+     * @return
+     */
+    std::string
+    constructMessage(const std::string &message, const std::string &trace, const std::string &logType,
+                     const std::string &format, const size_t *keys, const struct timespec &now, uint64_t number,
+                     const Context *context, const Thread *thread);
+
+    /**
+     * Construct the message from the format, or when multiline is set and the message has several lines,
+     * render the part of the format before %C once and copy it in front of each line
+     * @param message std::string Message ending with '\n'
+     * @param trace std::string
+     * @param logType std::string
+     * @param format std::string
+     * @param keys size_t Id of each %X{key} of the format
+     * @param multiline bool
+     * @param now Time of the log
+     * @param number Log number
+     * @param context Context
+     * @param thread Thread
+     * @return std::string
+     */
+    std::string
+    constructLines(const std::string &message, const std::string &trace, const std::string &logType,
+                   const std::string &format, const size_t *keys, bool multiline, const struct timespec &now,
+                   uint64_t number, const Context *context, const Thread *thread);
+
+    /**
+     * Write the log into the file
+     * @param message std::string
+     * @param number uint64_t Log number, written in front of the line by SHARDED_FILE
+     * @param now Time of the log, for the time index
+     */
+    void writeToFile(const std::string &message, uint64_t number, const struct timespec &now);
+
+    /**
+     * Add an entry to the time index if the line starts after the next interval
+     * @param offset uint64_t Offset of the line in the log file
+     * @param number uint64_t
+     * @param now Time of the log
+     */
+    void indexLine(uint64_t offset, uint64_t number, const struct timespec &now);
+
+    /**
+     * Open the log file
+     * @param fileName std::string
+     */
+    void openFile(const std::string &fileName);
+
+    /**
+     * Close the log file
+     */
+    void closeFile();
+
+    /**
+     * If the log file is open
+     * @return bool
+     */
+    bool isFileOpen();
+
+    /**
+     * Sync the written logs to the disk according to the durability of the type
+     * Called after the write, outside of the mutex
+     * @param type LoggerType
+     */
+    void syncFile(LoggerType type);
+
+    /**
+     * fdatasync() a file of the log and count it
+     * @param descriptor int
+     */
+    void dataSync(int descriptor);
+
+    /**
+     * Sync the shard of the calling thread, with the durability of the log's type
+     * Each shard has its own period and group commit, the fdatasync() runs outside the shard's mutex
+     * @param shard FileShard
+     * @param type LoggerType
+     */
+    void syncShard(FileShard &shard, LoggerType type);
+
+    /**
+     * Write the pending 'repeated' and 'suppressed' lines of a limiter
+     * @param limiter LoggerLimiter
+     */
+    void flushLimiter(LoggerLimiter &limiter);
+
+    /**
+     * Make this logger the owner of a limiter, the counts of the previous owner are written to it first
+     * @param limiter LoggerLimiter
+     */
+    void adoptLimiter(LoggerLimiter &limiter);
+
+    /**
+     * Monotonic clock, in nanoseconds
+     * @return int64_t
+     */
+    static int64_t monotonicNow();
+
+    /**
+     * The log's hour
+     * hh:mm:ss:nnn
+     * @param now Time of the log
+     * @return std::string
+     */
+    static std::string getHour(const struct timespec &now);
+
+    /**
+     * The log's date
+     * yyyy-mm-dd@hh-mm-ss
+     * @param now Time of the log
+     * @return std::string
+     */
+    static std::string getDate(const struct timespec &now);
+
+    /**
+     * Convert to the local time, without localtime() and its shared buffer
+     * The UTC offset is taken from the system once per quarter of an hour and per thread, at its start and
+     * its end, and the conversion itself is done here
+     * TZ is re-read with tzset() once per quarter, by the first thread which reaches it
+     * Each thread keeps the current and the previous quarter, a log stamped just before a new quarter is not a miss
+     * A quarter where the offset changes (a zone which does not change on a quarter) is converted by the system
+     * @param seconds time_t Seconds since the epoch
+     * @param res tm Filled with the date and the hour
+     */
+    static void localTime(time_t seconds, struct tm &res);
+
+    /**
+     * Keep the log in the flight recorder if its type is recorded
+     * @param recorder FlightRecorder
+     * @param function std::string
+     * @param message std::string
+     * @param type LoggerType
+     * @param option LoggerOption
+     * @param stamp uint64_t clockStamp() of the log, converted when the recorder is dumped
+     * @param fields Fields Fields of a structured log, nullptr for the others
+     * @return bool True if the log has been recorded
+     */
+    bool record(FlightRecorder &recorder, const std::string &function, const std::string &message, LoggerType type,
+                LoggerOption option, uint64_t stamp, const Fields *fields);
+
+    /**
+     * Read the clock
+     * @return uint64_t Nanoseconds since the epoch, or TSC ticks with TSC_CLOCK
+     */
+    static uint64_t clockStamp();
+
+    /**
+     * Convert a clockStamp() to the wall time
+     * @param stamp uint64_t
+     * @return timespec
+     */
+    static struct timespec stampToTime(uint64_t stamp);
+
+    /**
+     * Measure the TSC against CLOCK_REALTIME
+     * The first calibration measures during 1 ms, the next ones since the previous calibration
+     * @param initial bool
+     */
+    static void calibrateClock(bool initial);
+
+    /**
+     * Handler for dumpFlightRecorderOnSignal()
+     * @param signal int
+     */
+    static void flightRecorderSignal(int signal);
+
+    /**
+     * Take the current configuration, it and the flight recorder stay valid until releaseConfig()
+     * @param epoch unsigned Set to the counter index of the read, to give to releaseConfig()
+     * @return LoggerConfig
+     */
+    const LoggerConfig *acquireConfig(unsigned &epoch) {
+        epoch = configEpoch.load(std::memory_order_relaxed) & 1;
+        counters().configEnter[epoch].fetch_add(1, std::memory_order_seq_cst);
+        return config.load(std::memory_order_seq_cst);
+    }
+
+    /**
+     * Give back the configuration taken by acquireConfig()
+     * @param epoch unsigned The index set by acquireConfig()
+     */
+    void releaseConfig(unsigned epoch) {
+        counters().configExit[epoch].fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * Replace the configuration and free the previous one once no log reads it
+     * @param next LoggerConfig
+     */
+    void publishConfig(LoggerConfig *next);
+
+    /**
+     * Replace the flight recorder and free the previous one once no log reads it
+     * @param next FlightRecorder nullptr to disable the recorder
+     */
+    void publishFlightRecorder(FlightRecorder *next);
+
+    /**
+     * Grace period : wait until the logs which started before the call have called releaseConfig()
+     * Flip configEpoch so that new logs count on the other index, and only wait for the logs of the previous one
+     * Called under configMutex
+     */
+    void waitForReaders();
+
+    /**
+     * Wait until no log counts on the index
+     * @param epoch unsigned
+     */
+    void drainReaders(unsigned epoch);
+
+    /**
+     * Types of a module, one bit per LoggerType
+     * @param module std::string
+     * @return uint8_t
+     */
+    static uint8_t moduleMask(const std::string &module);
+
+    /**
+     * Add a rule for the DEBUG_LOG sites and apply it to the registered ones
+     * @param pattern std::string
+     * @param enabled bool
+     * @return size_t Number of registered sites matched
+     */
+    static size_t setSites(const std::string &pattern, bool enabled);
+
+    /**
+     * Run the commands of a connection to the site control socket
+     * @param client int
+     */
+    static void serveSiteControl(int client);
+
+    /**
+     * End of a span : its DEBUG log and its trace event
+     * @param span LoggerSpan
+     * @param end uint64_t clockStamp() at the end of the span
+     */
+    void endSpan(const LoggerSpan &span, uint64_t end);
+
+    /**
+     * Identifier of the calling thread, read once per thread
+     * @return uint64_t The kernel's thread id on Linux, a hash of std::thread::id elsewhere
+     */
+    static uint64_t threadId();
+
+private: // Shared by all the loggers
+    /**
+     * Source of the logs' time
+     */
+    static LoggerClockSource clockSource;
+    /**
+     * Odd while the TSC calibration is written (seqlock)
+     */
+    static std::atomic<uint32_t> clockSequence;
+    /**
+     * TSC at the last calibration
+     */
+    static std::atomic<uint64_t> tscBase;
+    /**
+     * Nanoseconds since the epoch at the last calibration
+     */
+    static std::atomic<int64_t> tscBaseNs;
+    /**
+     * Nanoseconds per TSC tick
+     */
+    static std::atomic<double> tscRate;
+    /**
+     * TSC ticks between two calibrations
+     */
+    static std::atomic<uint64_t> tscResync;
+    /**
+     * If a log is calibrating the TSC
+     */
+    static std::atomic<bool> tscCalibrating;
+    /**
+     * Incremented by the signal handler, each logger dumps when it differs from flightRecorderSeen
+     */
+    static volatile std::sig_atomic_t flightRecorderRequested;
+    /**
+     * Types set for the modules, one bit per LoggerType
+     */
+    static std::map<std::string, uint8_t> moduleTypes;
+    /**
+     * Protect moduleTypes
+     */
+    static pthread_mutex_t moduleMutex;
+    /**
+     * Ids of the keys of the contexts and of the %X{key} of the formats
+     */
+    static std::map<std::string, size_t> contextKeys;
+    /**
+     * Protect contextKeys
+     */
+    static pthread_mutex_t contextKeyMutex;
+    /**
+     * Rules of enableSites() and disableSites(), in order
+     */
+    static std::vector<std::pair<std::string, bool>> siteRules;
+    /**
+     * Protect siteRules and the registration of the sites
+     */
+    static pthread_mutex_t siteMutex;
+    /**
+     * Thread of openSiteControl(), never destroyed while it runs so the process can exit without closing it
+     */
+    static std::thread *siteControl;
+    /**
+     * Written to stop siteControl
+     */
+    static int siteControlStop;
+
+private:
+    /**
+     * If the logger is initialized
+     */
+    bool isInitialized;
+    /**
+     * The current configuration, replaced by publishConfig()
+     */
+    std::atomic<const LoggerConfig *> config;
+    /**
+     * Counter index of the new reads of the configuration, flipped by waitForReaders()
+     */
+    std::atomic<unsigned> configEpoch;
+    /**
+     * Serialize publishConfig()
+     */
+    pthread_mutex_t configMutex;
+    /**
+     * Thread of watchConfig()
+     */
+    std::thread configWatcher;
+    /**
+     * Written to stop configWatcher
+     */
+    int configStop;
+    /**
+     * The log file
+     */
+    std::ofstream file;
+    /**
+     * How the log file is written
+     */
+    LoggerFileMode fileMode;
+    /**
+     * The log file in DIRECT_FILE mode
+     */
+    int fileDescriptor;
+    /**
+     * End of the last reserved line in DIRECT_FILE mode, end of the last line in BUFFERED_FILE mode
+     */
+    std::atomic<int64_t> fileOffset;
+    /**
+     * The time index, -1 when disabled
+     */
+    int indexDescriptor;
+    /**
+     * Bytes of log file between two entries of the time index, 0 when disabled
+     */
+    uint64_t indexInterval;
+    /**
+     * A line starting at this offset or after gets an entry
+     */
+    std::atomic<uint64_t> nextIndexOffset;
+    /**
+     * Time of the last entry of the time index, the entries never go back in time
+     */
+    int64_t lastIndexTime;
+    /**
+     * Protect the entries of the time index
+     */
+    pthread_mutex_t indexMutex;
+
+    /**
+     * A file of SHARDED_FILE mode, on its own cache line
+     */
+    struct alignas(64) FileShard {
+        pthread_mutex_t mutex;
+        /**
+         * -1 until the first log of the shard
+         */
+        int descriptor;
+        /**
+         * Lines written to the shard, protected by mutex
+         */
+        uint64_t written;
+        /**
+         * Lines of the shard on the disk, and if a fdatasync() of the shard runs, protected by mutex
+         */
+        uint64_t synced;
+        bool syncing;
+        /**
+         * Signaled when a fdatasync() of the shard ends, with mutex
+         */
+        pthread_cond_t syncCondition;
+        /**
+         * Time of the last PERIODIC_SYNC of the shard (monotonic nanoseconds)
+         */
+        std::atomic<int64_t> lastSync;
+    };
+
+    /**
+     * The files of SHARDED_FILE mode, allocated aligned by posix_memalign(), nullptr in the other modes
+     */
+    FileShard *fileShards;
+    /**
+     * Number of files of SHARDED_FILE mode
+     */
+    unsigned fileShardCount;
+    /**
+     * Path of the log file without '.log', the shard and '.log' are appended
+     */
+    std::string fileShardBase;
+    /**
+     * Descriptor used for fdatasync(), the same as fileDescriptor in DIRECT_FILE mode
+     */
+    int syncDescriptor;
+    /**
+     * Durability of each log type
+     */
+    LoggerDurability durability[DEBUG + 1];
+    /**
+     * Period of PERIODIC_SYNC, in nanoseconds
+     */
+    int64_t syncPeriod;
+    /**
+     * Time of the last fdatasync() (monotonic nanoseconds)
+     */
+    std::atomic<int64_t> lastSync;
+    /**
+     * Number of writes done, a write gets its number once it is in the file
+     */
+    std::atomic<uint64_t> writtenCount;
+    /**
+     * Number of writes on the disk
+     */
+    uint64_t syncedCount;
+    /**
+     * If a log is running fdatasync() for the group
+     */
+    bool syncing;
+    /**
+     * Protect syncedCount and syncing
+     */
+    pthread_mutex_t syncMutex;
+    /**
+     * Wake the logs waiting for the group's fdatasync()
+     */
+    pthread_cond_t syncCondition;
+    /**
+     * Additional output for the logs
+     */
+    std::vector<std::ostream *> additionalStreams;
+    /**
+     * The number of log
+     */
+    std::atomic<uint64_t> nbLog;
+    /**
+     * The trace file of openTrace()
+     */
+    std::ofstream traceFile;
+    /**
+     * If the spans are written in traceFile
+     */
+    std::atomic<bool> tracing;
+    /**
+     * Protect traceFile
+     */
+    pthread_mutex_t traceMutex;
+    /**
+     * Process id written in the trace events
+     */
+    int tracePid;
+
+    /**
+     * Counters of a shard, on its own cache line
+     */
+    struct alignas(64) Counters {
+        std::atomic<uint64_t> messages[DEBUG + 1];
+        std::atomic<uint64_t> fileBytes;
+        std::atomic<uint64_t> consoleBytes;
+        std::atomic<uint64_t> streamBytes;
+        std::atomic<uint64_t> dropped;
+        std::atomic<uint64_t> suppressed;
+        std::atomic<uint64_t> recorded;
+        std::atomic<uint64_t> recorderHighWater;
+        std::atomic<uint64_t> flushes;
+        std::atomic<uint64_t> syncs;
+        std::atomic<uint64_t> writeErrors;
+        /*
+         * Logs of the shard which started and finished reading the configuration, for each index of configEpoch
+         * The shard does not read an old configuration once they are equal for both indexes
+         */
+        std::atomic<uint64_t> configEnter[2];
+        std::atomic<uint64_t> configExit[2];
+    };
+
+    /**
+     * Number of counter shards
+     */
+    static const unsigned SHARDS = 64;
+    /**
+     * The counter shards, threads are spread over them
+     */
+    Counters shards[SHARDS];
+    /**
+     * Shard of the next thread
+     */
+    static std::atomic<unsigned> nextShard;
+
+    /**
+     * The shard of the calling thread
+     * @return Counters
+     */
+    Counters &counters() {
+        return shards[shardIndex()];
+    }
+
+    /**
+     * Index of the shard of the calling thread, the same in all the loggers
+     * @return unsigned
+     */
+    static unsigned shardIndex() {
+        static thread_local unsigned shard = nextShard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+        return shard;
+    }
+
+    /**
+     * Histograms of a shard
+     */
+    struct Histograms {
+        std::atomic<uint64_t> buckets[SYNC_STAGE + 1][LoggerHistogram::BUCKETS];
+    };
+
+    /**
+     * Number of histogram shards, a shard is about 20 KB
+     */
+    static const unsigned HISTOGRAM_SHARDS = 16;
+    /**
+     * The histogram shards, allocated by the first enableHistograms()
+     */
+    std::unique_ptr<Histograms[]> histogramShards;
+    /**
+     * If the stages are measured
+     * Stored with release once histogramShards is set, loaded with acquire before measure() touches the shards
+     */
+    std::atomic<bool> histogramsEnabled;
+    /**
+     * A mutex for writeToFile(), to be thread-safe
+     */
+    LoggerMutex mutex;
+    /**
+     * The type of verbose
+     */
+    LoggerOption verbose;
+    /**
+     * The types of logs that be shown
+     */
+    std::vector <LoggerType> showTypes;
+
+    /**
+     * A log kept by the flight recorder
+     */
+    struct Record {
+        /**
+         * Position of the log in the recorder, ~0 when the slot is empty
+         */
+        uint64_t sequence;
+        /**
+         * clockStamp() of the log
+         */
+        uint64_t stamp;
+        LoggerType type;
+        LoggerOption option;
+        std::string function;
+        std::string message;
+        /**
+         * Fields of a structured log
+         */
+        Fields fields;
+        bool structured;
+        /**
+         * Context of the log's thread
+         */
+        std::shared_ptr<const Context> context;
+        /**
+         * Thread of the log
+         */
+        Thread thread;
+        /**
+         * Protect the slot against a concurrent write or dump
+         */
+        std::atomic_flag lock;
+    };
+
+    /**
+     * A flight recorder, published like the configuration : replaced, never modified, and freed once no log reads it
+     */
+    struct FlightRecorder {
+        /**
+         * Ring of the recorded logs
+         */
+        std::unique_ptr<Record[]> records;
+        /**
+         * Number of slots of the ring
+         */
+        size_t size;
+        /**
+         * The types of logs kept, one bit per LoggerType
+         */
+        uint8_t types;
+        /**
+         * Number of logs recorded since enableFlightRecorder()
+         */
+        std::atomic<uint64_t> head;
+        /**
+         * Number of logs already dumped
+         */
+        std::atomic<uint64_t> tail;
+    };
+
+    /**
+     * The current flight recorder, nullptr when disabled, read between acquireConfig() and releaseConfig()
+     */
+    std::atomic<FlightRecorder *> flightRecorder;
+    /**
+     * Last value of flightRecorderRequested handled by this logger
+     */
+    std::atomic<int> flightRecorderSeen;
+
+private: // Call sites resolve the types of their module and the rules, spans read the clock
+    friend class LoggerModuleSite;
+    friend class LoggerSite;
+    friend class LoggerSpan;
+
+private: // Benchmarks measure the internal stages
+    friend class LoggerBench;
+
+private: // Tests check the internal conversions
+    friend class LoggerTest;
+
+private: // Methods used for variadic functions
+    template<typename... Ts>
+    static std::string stringify(Ts const &... vals) {
+        std::string res;
+        stringifyTo(res, vals...);
+
+        return res;
+    }
+
+    template<typename... Ts>
+    static void stringifyTo(std::string &res, Ts const &... vals) {
+        /*
+         * Fill unused array with count(vals)+1 0
+         * The syntax (A,B) affect B value to array, but also do A due to comma operator
+         */
+        int unused[] = {0, (appendString(res, vals), 0)...};
+        (void) unused;
+    }
+
+    template<typename T>
+    static typename std::enable_if<false == std::is_convertible<T, std::string>::value>::type
+    appendString(std::string &res, T const &val) {
+        res += std::to_string(val);
+    }
+
+    static void appendString(std::string &res, std::string const &val) {
+        res += val;
+    }
+
+    static void appendString(std::string &res, const char *val) {
+        res += val;
+    }
+
+    /**
+     * FNV-1a hash of the arguments, without formatting them
+     * Each argument ends with its size, so "ab" "c" and "a" "bc" differ
+     * @return uint64_t Never 0
+     */
+    template<typename... Ts>
+    static uint64_t hashArgs(Ts const &... vals) {
+        uint64_t hash = 14695981039346656037ULL;
+
+        int unused[] = {0, (hash = hashArg(hash, vals), 0)...};
+        (void) unused;
+
+        return hash != 0 ? hash : 1;
+    }
+
+    static uint64_t hashBytes(uint64_t hash, const void *data, size_t size) {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+
+        hash ^= size;
+        return hash * 1099511628211ULL;
+    }
+
+    template<typename T>
+    static typename std::enable_if<false == std::is_convertible<T, std::string>::value, uint64_t>::type
+    hashArg(uint64_t hash, T const &val) {
+        return hashBytes(hash, &val, sizeof(val));
+    }
+
+    static uint64_t hashArg(uint64_t hash, std::string const &val) {
+        return hashBytes(hash, val.data(), val.size());
+    }
+
+    static uint64_t hashArg(uint64_t hash, const char *val) {
+        return hashBytes(hash, val, strlen(val));
+    }
+};
+
+#define INFO_LOG(option, msg...) Logger::global().info(__FUNCTION__, option, msg)
+#define SUCCESS_LOG(option, msg...) Logger::global().success(__FUNCTION__, option, msg)
+#define ERROR_LOG(option, msg...) Logger::global().error(__FUNCTION__, option, msg)
+#define WARNING_LOG(option, msg...) Logger::global().warning(__FUNCTION__, option, msg)
+#define DEBUG_LOG(option, msg...) DEBUG_LOG_TO(Logger::global(), option, msg)
+
+/*
+ * Structured logs, a message followed by keys and their value :
+ * INFO_KV(FILE_ONLY, "Request served", "user", id, "ms", duration);
+ * Write 'Request served user=42 ms=3.5', or in the JSON file
+ * {"seq":3,"time":"...","level":"INFO","trace":"serve","message":"Request served","user":42,"ms":3.5}
+ */
+#define INFO_KV(option, message, fields...) INFO_KV_TO(Logger::global(), option, message, ##fields)
+#define SUCCESS_KV(option, message, fields...) SUCCESS_KV_TO(Logger::global(), option, message, ##fields)
+#define ERROR_KV(option, message, fields...) ERROR_KV_TO(Logger::global(), option, message, ##fields)
+#define WARNING_KV(option, message, fields...) WARNING_KV_TO(Logger::global(), option, message, ##fields)
+#define DEBUG_KV(option, message, fields...) DEBUG_KV_TO(Logger::global(), option, message, ##fields)
+
+/*
+ * Logs of another logger :
+ * Logger audit("audit");
+ * audit.open(FILE_ONLY);
+ * INFO_LOG_TO(audit, FILE_ONLY, "User ", id, " logged in");
+ * Each macro below has its _TO variant, which takes the logger first
+ */
+#define INFO_LOG_TO(logger, option, msg...) (logger).info(__FUNCTION__, option, msg)
+#define SUCCESS_LOG_TO(logger, option, msg...) (logger).success(__FUNCTION__, option, msg)
+#define ERROR_LOG_TO(logger, option, msg...) (logger).error(__FUNCTION__, option, msg)
+#define WARNING_LOG_TO(logger, option, msg...) (logger).warning(__FUNCTION__, option, msg)
+#define DEBUG_LOG_TO(logger, option, msg...) do { \
+        static LoggerSite loggerSite(__FUNCTION__, __FILE__, __LINE__); \
+        if (loggerSite.isEnabled()) \
+            (logger).debug(__FUNCTION__, option, msg); \
+    } while (0)
+
+#define INFO_KV_TO(logger, option, message, fields...) (logger).kv(INFO, __FUNCTION__, option, message, ##fields)
+#define SUCCESS_KV_TO(logger, option, message, fields...) \
+    (logger).kv(SUCCESS, __FUNCTION__, option, message, ##fields)
+#define ERROR_KV_TO(logger, option, message, fields...) (logger).kv(ERROR, __FUNCTION__, option, message, ##fields)
+#define WARNING_KV_TO(logger, option, message, fields...) \
+    (logger).kv(WARNING, __FUNCTION__, option, message, ##fields)
+#define DEBUG_KV_TO(logger, option, message, fields...) do { \
+        static LoggerSite loggerSite(__FUNCTION__, __FILE__, __LINE__); \
+        if (loggerSite.isEnabled()) \
+            (logger).kv(DEBUG, __FUNCTION__, option, message, ##fields); \
+    } while (0)
+
+/*
+ * Rate limited logs :
+ * ERROR_LOG_LIMITED(FILE_ONLY, 10, 5, "Connection failed");
+ * Write at most 10 lines per second (5 at once) from this call site,
+ * identical consecutive messages are collapsed
+ * The limit of a call site is shared by the loggers it writes to,
+ * the 'repeated' and 'suppressed' counts go to the logger of its last line
+ */
+#define LOGGER_LIMITED_TO(logger, type, option, perSecond, burst, msg...) do { \
+        static LoggerLimiter loggerLimiter(__FUNCTION__, type, option, perSecond, burst); \
+        (logger).limited(loggerLimiter, msg); \
+    } while (0)
+#define LOGGER_LIMITED(type, option, perSecond, burst, msg...) \
+    LOGGER_LIMITED_TO(Logger::global(), type, option, perSecond, burst, msg)
+
+#define INFO_LOG_LIMITED(option, perSecond, burst, msg...) LOGGER_LIMITED(INFO, option, perSecond, burst, msg)
+#define SUCCESS_LOG_LIMITED(option, perSecond, burst, msg...) LOGGER_LIMITED(SUCCESS, option, perSecond, burst, msg)
+#define ERROR_LOG_LIMITED(option, perSecond, burst, msg...) LOGGER_LIMITED(ERROR, option, perSecond, burst, msg)
+#define WARNING_LOG_LIMITED(option, perSecond, burst, msg...) LOGGER_LIMITED(WARNING, option, perSecond, burst, msg)
+#define DEBUG_LOG_LIMITED(option, perSecond, burst, msg...) LOGGER_LIMITED(DEBUG, option, perSecond, burst, msg)
+
+#define INFO_LOG_LIMITED_TO(logger, option, perSecond, burst, msg...) \
+    LOGGER_LIMITED_TO(logger, INFO, option, perSecond, burst, msg)
+#define SUCCESS_LOG_LIMITED_TO(logger, option, perSecond, burst, msg...) \
+    LOGGER_LIMITED_TO(logger, SUCCESS, option, perSecond, burst, msg)
+#define ERROR_LOG_LIMITED_TO(logger, option, perSecond, burst, msg...) \
+    LOGGER_LIMITED_TO(logger, ERROR, option, perSecond, burst, msg)
+#define WARNING_LOG_LIMITED_TO(logger, option, perSecond, burst, msg...) \
+    LOGGER_LIMITED_TO(logger, WARNING, option, perSecond, burst, msg)
+#define DEBUG_LOG_LIMITED_TO(logger, option, perSecond, burst, msg...) \
+    LOGGER_LIMITED_TO(logger, DEBUG, option, perSecond, burst, msg)
+
+/*
+ * Sampled logs, the arguments are not evaluated for skipped calls :
+ * INFO_LOG_EVERY_N(FILE_ONLY, 100, "Iteration ", i);
+ * Write the 1st, 101st, 201st... call of this call site, each call when n <= 1
+ * DEBUG_LOG_SAMPLED(FILE_ONLY, 0.01, "Request ", id);
+ * Write each call with a probability of 1%
+ */
+#define LOGGER_EVERY_N_TO(logger, method, option, n, msg...) do { \
+        static std::atomic<uint64_t> loggerCounter(0); \
+        auto loggerEvery = (n); \
+        if (loggerEvery <= 1 || loggerCounter.fetch_add(1, std::memory_order_relaxed) % (uint64_t) loggerEvery == 0) \
+            (logger).method(__FUNCTION__, option, msg); \
+    } while (0)
+#define LOGGER_EVERY_N(method, option, n, msg...) LOGGER_EVERY_N_TO(Logger::global(), method, option, n, msg)
+
+#define LOGGER_SAMPLED_TO(logger, method, option, ratio, msg...) do { \
+        if (Logger::sample(ratio)) \
+            (logger).method(__FUNCTION__, option, msg); \
+    } while (0)
+#define LOGGER_SAMPLED(method, option, ratio, msg...) LOGGER_SAMPLED_TO(Logger::global(), method, option, ratio, msg)
+
+#define INFO_LOG_EVERY_N(option, n, msg...) LOGGER_EVERY_N(info, option, n, msg)
+#define SUCCESS_LOG_EVERY_N(option, n, msg...) LOGGER_EVERY_N(success, option, n, msg)
+#define ERROR_LOG_EVERY_N(option, n, msg...) LOGGER_EVERY_N(error, option, n, msg)
+#define WARNING_LOG_EVERY_N(option, n, msg...) LOGGER_EVERY_N(warning, option, n, msg)
+#define DEBUG_LOG_EVERY_N(option, n, msg...) LOGGER_EVERY_N(debug, option, n, msg)
+
+#define INFO_LOG_EVERY_N_TO(logger, option, n, msg...) LOGGER_EVERY_N_TO(logger, info, option, n, msg)
+#define SUCCESS_LOG_EVERY_N_TO(logger, option, n, msg...) LOGGER_EVERY_N_TO(logger, success, option, n, msg)
+#define ERROR_LOG_EVERY_N_TO(logger, option, n, msg...) LOGGER_EVERY_N_TO(logger, error, option, n, msg)
+#define WARNING_LOG_EVERY_N_TO(logger, option, n, msg...) LOGGER_EVERY_N_TO(logger, warning, option, n, msg)
+#define DEBUG_LOG_EVERY_N_TO(logger, option, n, msg...) LOGGER_EVERY_N_TO(logger, debug, option, n, msg)
+
+#define INFO_LOG_SAMPLED(option, ratio, msg...) LOGGER_SAMPLED(info, option, ratio, msg)
+#define SUCCESS_LOG_SAMPLED(option, ratio, msg...) LOGGER_SAMPLED(success, option, ratio, msg)
+#define ERROR_LOG_SAMPLED(option, ratio, msg...) LOGGER_SAMPLED(error, option, ratio, msg)
+#define WARNING_LOG_SAMPLED(option, ratio, msg...) LOGGER_SAMPLED(warning, option, ratio, msg)
+#define DEBUG_LOG_SAMPLED(option, ratio, msg...) LOGGER_SAMPLED(debug, option, ratio, msg)
+
+#define INFO_LOG_SAMPLED_TO(logger, option, ratio, msg...) LOGGER_SAMPLED_TO(logger, info, option, ratio, msg)
+#define SUCCESS_LOG_SAMPLED_TO(logger, option, ratio, msg...) LOGGER_SAMPLED_TO(logger, success, option, ratio, msg)
+#define ERROR_LOG_SAMPLED_TO(logger, option, ratio, msg...) LOGGER_SAMPLED_TO(logger, error, option, ratio, msg)
+#define WARNING_LOG_SAMPLED_TO(logger, option, ratio, msg...) LOGGER_SAMPLED_TO(logger, warning, option, ratio, msg)
+#define DEBUG_LOG_SAMPLED_TO(logger, option, ratio, msg...) LOGGER_SAMPLED_TO(logger, debug, option, ratio, msg)
+
+#define LOGGER_CONCAT_(a, b) a##b
+#define LOGGER_CONCAT(a, b) LOGGER_CONCAT_(a, b)
+
+/*
+ * Timed scopes :
+ * {
+ *     LOG_SCOPE_TIMER(FILE_ONLY, "parse");
+ *     ...
+ * }
+ * Write 'parse took 12.345 us' as a DEBUG log at the end of the scope, and its event in the trace file
+ */
+#define LOG_SCOPE_TIMER(option, name) \
+    LoggerSpan LOGGER_CONCAT(loggerSpan, __LINE__)(Logger::global(), option, name, __FUNCTION__)
+#define LOG_SCOPE_TIMER_TO(logger, option, name) \
+    LoggerSpan LOGGER_CONCAT(loggerSpan, __LINE__)(logger, option, name, __FUNCTION__)
+
+/*
+ * Trace-only scopes, for hot code :
+ * LOG_SCOPE_TRACE("decode");
+ * Write the event of the scope in the trace file, without DEBUG log, and nothing when the logger does not trace
+ */
+#define LOG_SCOPE_TRACE(name) LoggerSpan LOGGER_CONCAT(loggerSpan, __LINE__)(Logger::global(), name, __FUNCTION__)
+#define LOG_SCOPE_TRACE_TO(logger, name) LoggerSpan LOGGER_CONCAT(loggerSpan, __LINE__)(logger, name, __FUNCTION__)
+
+/*
+ * Logs of a module, the arguments are not evaluated when the type is disabled for the module :
+ * Logger::setModuleTypes("net", {ERROR, WARNING});
+ * Logger::setModuleTypes("net.http", {INFO, ERROR, WARNING, DEBUG});
+ * DEBUG_LOG_MODULE("net.http", FILE_ONLY, "Request ", id);
+ * Written, while DEBUG_LOG_MODULE("net.tcp", ...) is not
+ * The types of the modules are shared by all the loggers
+ */
+#define LOGGER_MODULE_TO(logger, method, type, module, option, msg...) do { \
+        static LoggerModuleSite loggerModuleSite(module); \
+        if (loggerModuleSite.isEnabled(type)) \
+            (logger).method(__FUNCTION__, option, msg); \
+    } while (0)
+#define LOGGER_MODULE(method, type, module, option, msg...) \
+    LOGGER_MODULE_TO(Logger::global(), method, type, module, option, msg)
+
+#define INFO_LOG_MODULE(module, option, msg...) LOGGER_MODULE(info, INFO, module, option, msg)
+#define SUCCESS_LOG_MODULE(module, option, msg...) LOGGER_MODULE(success, SUCCESS, module, option, msg)
+#define ERROR_LOG_MODULE(module, option, msg...) LOGGER_MODULE(error, ERROR, module, option, msg)
+#define WARNING_LOG_MODULE(module, option, msg...) LOGGER_MODULE(warning, WARNING, module, option, msg)
+#define DEBUG_LOG_MODULE(module, option, msg...) LOGGER_MODULE(debug, DEBUG, module, option, msg)
 
-#define INFO_LOG(option, msg...) Logger::info(__FUNCTION__, option, msg)
-#define SUCCESS_LOG(option, msg...) Logger::success(__FUNCTION__, option, msg)
-#define ERROR_LOG(option, msg...) Logger::error(__FUNCTION__, option, msg)
-#define WARNING_LOG(option, msg...) Logger::warning(__FUNCTION__, option, msg)
-#define DEBUG_LOG(option, msg...) Logger::debug(__FUNCTION__, option, msg)
+#define INFO_LOG_MODULE_TO(logger, module, option, msg...) LOGGER_MODULE_TO(logger, info, INFO, module, option, msg)
+#define SUCCESS_LOG_MODULE_TO(logger, module, option, msg...) \
+    LOGGER_MODULE_TO(logger, success, SUCCESS, module, option, msg)
+#define ERROR_LOG_MODULE_TO(logger, module, option, msg...) \
+    LOGGER_MODULE_TO(logger, error, ERROR, module, option, msg)
+#define WARNING_LOG_MODULE_TO(logger, module, option, msg...) \
+    LOGGER_MODULE_TO(logger, warning, WARNING, module, option, msg)
+#define DEBUG_LOG_MODULE_TO(logger, module, option, msg...) \
+    LOGGER_MODULE_TO(logger, debug, DEBUG, module, option, msg)
 
 #endif //LOGGER_LOGGER_HPP
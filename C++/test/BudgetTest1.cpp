@@ -0,0 +1,96 @@
+#include "test.h"
+#include "counters.h"
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Compte les allocations et les écritures faites par 1000 appels à log
+ * Le premier appel est fait avant la mesure, pour les sites qui écrivent leur premier log
+ */
+template<typename F>
+static void measure(F log, uint64_t &allocations, uint64_t &writes, uint64_t &syncs) {
+    log(0);
+
+    uint64_t allocationsBefore = allocationCount.load();
+    uint64_t writesBefore = writeCount.load();
+    uint64_t syncsBefore = syncCount.load();
+    for (int i = 1; i <= 1000; i++) {
+        log(i);
+    }
+    allocations = allocationCount.load() - allocationsBefore;
+    writes = writeCount.load() - writesBefore;
+    syncs = syncCount.load() - syncsBefore;
+}
+
+/**
+ * Test budget 1 :
+ * Initialise le logger, mesure les allocations et les appels système de 1000 logs pour chaque mode
+ * et exit le logger.
+ *
+ * Conditions de réussite :
+ * - Les logs ignorés (échantillonnés ou limités) ne font aucune allocation et aucune écriture.
+ * - Les logs gardés par l'enregistreur ne font aucune allocation et aucune écriture.
+ * - Les logs écrits dans le fichier font au plus 1 écriture par ligne.
+ * - Les logs en PERIODIC_SYNC font au plus 1 fdatasync pour 1000 lignes.
+ */
+Test BudgetTest1 = {
+        "BudgetTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger::init(FILE_ONLY);
+
+            uint64_t allocations;
+            uint64_t writes;
+            uint64_t syncs;
+            bool result = true;
+
+            // Les logs ignorés (échantillonnés ou limités) ne font aucune allocation et aucune écriture.
+            measure([](int i) {
+                DEBUG_LOG_EVERY_N(FILE_ONLY, 1000000, "Skipped by the sampling or the rate limit ", i);
+            }, allocations, writes, syncs);
+            result = result && allocations == 0 && writes == 0;
+            measure([](int i) {
+                DEBUG_LOG_SAMPLED(FILE_ONLY, 0, "Skipped by the sampling or the rate limit ", i);
+            }, allocations, writes, syncs);
+            result = result && allocations == 0 && writes == 0;
+            measure([](int i) {
+                DEBUG_LOG_LIMITED(FILE_ONLY, 0.001, 1, "Skipped by the sampling or the rate limit ", i);
+            }, allocations, writes, syncs);
+            result = result && allocations == 0 && writes == 0;
+
+            // Les logs gardés par l'enregistreur ne font aucune allocation et aucune écriture.
+            Logger::global().enableFlightRecorder(100, {DEBUG});
+            measure([](int i) {
+                DEBUG_LOG(FILE_ONLY, "Recorded by the flight recorder only ", i);
+            }, allocations, writes, syncs);
+            result = result && allocations == 0 && writes == 0;
+            Logger::global().disableFlightRecorder();
+
+            // Les logs écrits dans le fichier font au plus 1 écriture par ligne.
+            measure([](int i) {
+                INFO_LOG(FILE_ONLY, "Written ", i);
+            }, allocations, writes, syncs);
+            result = result && writes <= 1000 && syncs == 0;
+#ifdef __linux__
+            // Les écritures sont bien comptées
+            result = result && writes > 0;
+#endif
+
+            // Les logs en PERIODIC_SYNC font au plus 1 fdatasync pour 1000 lignes.
+            Logger::global().setDurability(PERIODIC_SYNC, {INFO}, 3600000);
+            measure([](int i) {
+                INFO_LOG(FILE_ONLY, "Synced ", i);
+            }, allocations, writes, syncs);
+            result = result && syncs <= 1;
+            Logger::global().setDurability(NO_SYNC);
+
+            Logger::exit();
+
+            return result;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
@@ -0,0 +1,99 @@
+#include "test.h"
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Heure d'une ligne de log, en secondes depuis minuit
+ * Le format du fichier commence par [%n-%h-%t], %h étant H:m:S:N
+ */
+static int secondsOfDay(const std::string &line) {
+    size_t start = line.find('-');
+    if (start == std::string::npos) {
+        return -1;
+    }
+    int h, m, s;
+    if (sscanf(line.c_str() + start + 1, "%d:%d:%d", &h, &m, &s) != 3) {
+        return -1;
+    }
+
+    return h * 3600 + m * 60 + s;
+}
+
+/**
+ * Test horloge 1 :
+ * Pour chaque source d'horloge, initialise le logger, log une ligne en info et exit le logger.
+ *
+ * Conditions de réussite :
+ * - Le dossier logs contient un seul fichier .log.
+ * - Le fichier .log contient une ligne "clock".
+ * - L'heure de la ligne est à moins de 2 secondes de l'heure du système.
+ */
+Test ClockTest1 = {
+        "ClockTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            for (LoggerClockSource source: {REALTIME_CLOCK, COARSE_CLOCK, TSC_CLOCK}) {
+                Logger::setClock(source);
+                Logger::init();
+                INFO_LOG(FILE_ONLY, "clock");
+                Logger::exit();
+
+                time_t now = time(nullptr);
+                struct tm *t = localtime(&now);
+                int expected = t->tm_hour * 3600 + t->tm_min * 60 + t->tm_sec;
+
+                // ====================
+
+                // Le dossier logs contient un seul fichier .log.
+                DIR *dir = opendir("logs");
+                if (dir == nullptr) {
+                    return false;
+                }
+                struct dirent *ent;
+                int nbFiles = 0;
+                std::string fileName;
+                while ((ent = readdir(dir)) != nullptr) {
+                    if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                        nbFiles++;
+                        fileName = ent->d_name;
+                    }
+                }
+                closedir(dir);
+                if (nbFiles != 1) {
+                    return false;
+                }
+
+                // Le fichier .log contient une ligne "clock".
+                std::ifstream file("logs/" + fileName);
+                if (!file.is_open()) {
+                    return false;
+                }
+                std::string line;
+                std::string clockLine;
+                while (std::getline(file, line)) {
+                    if (line.find("clock") != std::string::npos) {
+                        clockLine = line;
+                    }
+                }
+                file.close();
+                rmDir("logs");
+                if (clockLine.empty()) {
+                    return false;
+                }
+
+                // L'heure de la ligne est à moins de 2 secondes de l'heure du système.
+                int diff = (expected - secondsOfDay(clockLine) + 86400) % 86400;
+                if (secondsOfDay(clockLine) < 0 || (diff > 2 && diff < 86398)) {
+                    return false;
+                }
+            }
+
+            return true;
+        },
+        []() {
+            Logger::setClock(REALTIME_CLOCK);
+            rmDir("logs");
+        }
+};
@@ -0,0 +1,106 @@
+#include "test.h"
+#include <thread>
+#include <cstdio>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test configuration 1 :
+ * Écrit un fichier de configuration avec le format "%t|%C", le surveille, initialise le logger et log en info.
+ * Remplace le fichier par un autre avec le format "%n\t%C", attend son chargement et log en info.
+ * Lance un thread qui log 200 fois pendant que les formats sont changés 100 fois, puis exit le logger.
+ *
+ * Conditions de réussite :
+ * - Le premier log est écrit au format du premier fichier.
+ * - Le second log est écrit au format du fichier remplacé.
+ * - Les logs écrits pendant les changements sont chacun à l'un des deux formats.
+ */
+Test ConfigTest1 = {
+        "ConfigTest1",
+        []() {
+            std::ofstream conf("logger.conf");
+            conf << "# Test configuration" << std::endl << "file_format = %t|%C" << std::endl;
+        },
+        []() {
+            Logger::global().watchConfig("logger.conf");
+            Logger::init();
+
+            INFO_LOG(FILE_ONLY, "first");
+
+            {
+                std::ofstream conf("logger.conf.tmp");
+                conf << "file_format = %n\\t%C   # escaped tabulation" << std::endl;
+            }
+            rename("logger.conf.tmp", "logger.conf");
+            for (int i = 0; i < 200 && Logger::global().getConfig().fileFormat != "%n\t%C"; i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+
+            INFO_LOG(FILE_ONLY, "second");
+
+            std::thread t([]() {
+                for (int i = 0; i < 200; i++) {
+                    INFO_LOG(FILE_ONLY, "swap");
+                }
+            });
+            for (int i = 0; i < 100; i++) {
+                Logger::global().setFormats(CONSOLE_FORMAT, i % 2 == 0 ? "%t|%C" : "%n\t%C", ADDITIONAL_FORMAT);
+            }
+            t.join();
+
+            Logger::exit();
+
+            // ====================
+
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+            if (lines.size() != 205) {
+                return false;
+            }
+
+            // Le premier log est écrit au format du premier fichier.
+            if (lines[2] != "INFO|first") {
+                return false;
+            }
+
+            // Le second log est écrit au format du fichier remplacé.
+            if (lines[3] != "3\tsecond") {
+                return false;
+            }
+
+            // Les logs écrits pendant les changements sont chacun à l'un des deux formats.
+            for (size_t i = 4; i < 204; i++) {
+                if (lines[i] != "INFO|swap" && lines[i] != std::to_string(i) + "\tswap") {
+                    return false;
+                }
+            }
+
+            return true;
+        },
+        []() {
+            Logger::global().unwatchConfig();
+            Logger::global().setFormats(CONSOLE_FORMAT, FILE_FORMAT, ADDITIONAL_FORMAT);
+            remove("logger.conf");
+            rmDir("logs");
+        }
+};
@@ -0,0 +1,121 @@
+#include "test.h"
+#include <thread>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test configuration 2 :
+ * Initialise un logger "publish", lance 8 threads qui log en info sans pause
+ * pendant que le thread principal change les formats 50 fois, puis arrête les threads et ferme le logger.
+ *
+ * Conditions de réussite :
+ * - Chaque thread a logué pendant les changements.
+ * - Les 50 changements se terminent en moins de 10 secondes malgré les logs continus.
+ * - Le fichier contient tous les logs, chacun à l'un des deux formats.
+ */
+Test ConfigTest2 = {
+        "ConfigTest2",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger logger("publish");
+            logger.setFormats(CONSOLE_FORMAT, "%t|%C", ADDITIONAL_FORMAT);
+            logger.open(FILE_ONLY);
+
+            std::atomic<bool> stop(false);
+            std::atomic<int> started(0);
+            std::vector<std::atomic<int>> counts(8);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 8; t++) {
+                threads.emplace_back([&logger, &stop, &started, &counts, t]() {
+                    INFO_LOG_TO(logger, FILE_ONLY, "run");
+                    started++;
+                    while (!stop.load()) {
+                        INFO_LOG_TO(logger, FILE_ONLY, "run");
+                        counts[t]++;
+                    }
+                });
+            }
+            while (started.load() < 8) {
+                std::this_thread::yield();
+            }
+
+            std::vector<int> before(counts.size());
+            for (size_t t = 0; t < counts.size(); t++) {
+                before[t] = counts[t].load();
+            }
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < 50; i++) {
+                logger.setFormats(CONSOLE_FORMAT, i % 2 == 0 ? "%n\t%C" : "%t|%C", ADDITIONAL_FORMAT);
+            }
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            std::vector<int> during(counts.size());
+            for (size_t t = 0; t < counts.size(); t++) {
+                during[t] = counts[t].load() - before[t];
+            }
+            stop = true;
+            for (auto &thread: threads) {
+                thread.join();
+            }
+
+            logger.close();
+
+            // ====================
+
+            // Chaque thread a logué pendant les changements.
+            for (int count: during) {
+                if (count <= 0) {
+                    return false;
+                }
+            }
+
+            // Les 50 changements se terminent en moins de 10 secondes malgré les logs continus.
+            if (elapsed > std::chrono::seconds(10)) {
+                return false;
+            }
+
+            // Le fichier contient tous les logs, chacun à l'un des deux formats.
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            size_t total = 8;
+            for (auto &count: counts) {
+                total += count.load();
+            }
+            size_t nbRuns = 0;
+            std::string line;
+            while (std::getline(file, line)) {
+                if (line.length() < 3 || line.compare(line.length() - 3, 3, "run") != 0) {
+                    continue;
+                }
+                size_t digits = line.find_first_not_of("0123456789");
+                if (line != "INFO|run" && (digits == 0 || line.compare(digits, std::string::npos, "\trun") != 0)) {
+                    return false;
+                }
+                nbRuns++;
+            }
+            file.close();
+            if (nbRuns != total) {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
@@ -0,0 +1,122 @@
+#include "test.h"
+#include <thread>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test contexte 1 :
+ * Initialise un logger "context" qui écrit le contexte avec %X{request} et %X, et un logger "json" qui écrit son
+ * fichier en JSON. Remplit le contexte du thread, log avec chacun, log depuis un autre thread, retire un champ,
+ * log un message de deux lignes avec un format dont la clé user n'existait pas quand le contexte a été rempli,
+ * vide le contexte et ferme les deux loggers.
+ *
+ * Conditions de réussite :
+ * - Le fichier texte contient 9 lignes de logs.
+ * - Les logs écrits avec un contexte contiennent ses champs, les autres des champs vides.
+ * - Le contexte d'un thread n'est pas écrit par les logs d'un autre thread.
+ * - Chaque ligne du message de deux lignes contient les champs de son format, vide pour la clé absente.
+ * - Le log JSON contient les champs du contexte.
+ */
+Test ContextTest1 = {
+        "ContextTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger text("context");
+            text.setFormats(CONSOLE_FORMAT, "[%t]\t[%X{request}]\t[%X]\t%C", ADDITIONAL_FORMAT);
+            text.open(FILE_ONLY);
+            Logger json("json");
+            json.setJsonFile(true);
+            json.open(FILE_ONLY);
+
+            Logger::setContext("request", "42");
+            Logger::setContext("tenant", "acme");
+            INFO_LOG_TO(text, FILE_ONLY, "a");
+            INFO_LOG_TO(json, FILE_ONLY, "a");
+            std::thread other([&text]() {
+                INFO_LOG_TO(text, FILE_ONLY, "b");
+            });
+            other.join();
+            Logger::removeContext("tenant");
+            INFO_LOG_TO(text, FILE_ONLY, "c");
+            text.setFormats(CONSOLE_FORMAT, "[%X{user}]\t[%X{request}]\t%C", ADDITIONAL_FORMAT);
+            text.setMultiline(true);
+            INFO_LOG_TO(text, FILE_ONLY, "e\nf");
+            text.setMultiline(false);
+            text.setFormats(CONSOLE_FORMAT, "[%t]\t[%X{request}]\t[%X]\t%C", ADDITIONAL_FORMAT);
+            Logger::clearContext();
+            INFO_LOG_TO(text, FILE_ONLY, "d");
+
+            json.close();
+            text.close();
+
+            // ====================
+
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string textName;
+            std::string jsonName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strncmp(ent->d_name, "json_", 5) == 0) {
+                    jsonName = ent->d_name;
+                } else if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    textName = ent->d_name;
+                }
+            }
+            closedir(dir);
+
+            std::ifstream file("logs/" + textName);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+
+            // Le fichier texte contient 9 lignes de logs.
+            if (lines.size() != 9) {
+                return false;
+            }
+
+            // Les logs écrits avec un contexte contiennent ses champs, les autres des champs vides.
+            if (lines[2] != "[INFO]\t[42]\t[request=42 tenant=acme]\ta" || lines[4] != "[INFO]\t[42]\t[request=42]\tc" ||
+                lines[7] != "[INFO]\t[]\t[]\td") {
+                return false;
+            }
+
+            // Le contexte d'un thread n'est pas écrit par les logs d'un autre thread.
+            if (lines[3] != "[INFO]\t[]\t[]\tb") {
+                return false;
+            }
+
+            // Chaque ligne du message de deux lignes contient les champs de son format, vide pour la clé absente.
+            if (lines[5] != "[]\t[42]\te" || lines[6] != "[]\t[42]\tf") {
+                return false;
+            }
+
+            // Le log JSON contient les champs du contexte.
+            file.open("logs/" + jsonName);
+            if (!file.is_open()) {
+                return false;
+            }
+            lines.clear();
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+            std::string end = "\"message\":\"a\",\"request\":\"42\",\"tenant\":\"acme\"}";
+            return lines.size() == 3 && lines[1].length() > end.length() &&
+                   lines[1].compare(lines[1].length() - end.length(), end.length(), end) == 0;
+        },
+        []() {
+            Logger::clearContext();
+            rmDir("logs");
+        }
+};
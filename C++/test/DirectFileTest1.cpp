@@ -0,0 +1,96 @@
+#include "test.h"
+#include <thread>
+#include <regex>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test fichier direct 1 :
+ * Initialise le logger en mode DIRECT_FILE, lance 4 threads qui log chacun 250 fois en info
+ * et exit le logger après avoir join les threads.
+ *
+ * Conditions de réussite :
+ * - Le dossier logs est créé.
+ * - Il contient un seul fichier .log.
+ * - Le fichier .log contient 1003 lignes de logs.
+ * - Les lignes des threads sont bien formées (aucune ligne coupée).
+ */
+Test DirectFileTest1 = {
+        "DirectFileTest1",
+        []() {
+            Logger::global().setFileMode(DIRECT_FILE);
+        },
+        []() {
+            Logger::init();
+
+            std::vector<std::thread> threads;
+            for (int i = 0; i < 4; i++) {
+                threads.emplace_back([i]() {
+                    for (int j = 0; j < 250; j++) {
+                        INFO_LOG(FILE_ONLY, "thread ", i, " line ", j);
+                    }
+                });
+            }
+            for (auto &t: threads) {
+                t.join();
+            }
+
+            Logger::exit();
+
+            // ====================
+
+            // Le dossier logs est créé.
+            struct stat buffer{};
+            if (stat("logs", &buffer) != 0 || !S_ISDIR(buffer.st_mode)) {
+                return false;
+            }
+
+            // Il contient un seul fichier .log.
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            int nbFiles = 0;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    nbFiles++;
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            if (nbFiles != 1) {
+                return false;
+            }
+
+            // Le fichier .log contient 1003 lignes de logs.
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+            if (lines.size() != 1003) {
+                return false;
+            }
+
+            // Les lignes des threads sont bien formées (aucune ligne coupée).
+            std::regex regex("(.*)-INFO\\]\t\\[operator\\(\\)\\]\tthread [0-3] line [0-9]+");
+            for (size_t i = 2; i < lines.size() - 1; i++) {
+                if (!std::regex_match(lines[i], regex)) {
+                    return false;
+                }
+            }
+
+            return true;
+        },
+        []() {
+            Logger::global().setFileMode(BUFFERED_FILE);
+            rmDir("logs");
+        }
+};
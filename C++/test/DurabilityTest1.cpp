@@ -0,0 +1,112 @@
+#include "test.h"
+#include <thread>
+#ifdef __linux__
+#include <sys/vfs.h>
+#include <linux/magic.h>
+#endif
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test durabilité 1 :
+ * Initialise le logger avec les erreurs en GROUP_COMMIT et les infos en PERIODIC_SYNC, lance 8 threads qui log
+ * chacun 50 fois en erreur et 50 fois en info et exit le logger après avoir join les threads.
+ *
+ * Conditions de réussite :
+ * - Le dossier logs est créé.
+ * - Il contient un seul fichier .log.
+ * - Le fichier .log contient 803 lignes de logs.
+ * - Les logs ont fait des fdatasync.
+ * - Les 400 erreurs partagent leurs fdatasync : il y en a moins que d'erreurs (sauf sur tmpfs, où fdatasync ne
+ *   fait rien et se termine avant que les autres threads n'écrivent).
+ */
+Test DurabilityTest1 = {
+        "DurabilityTest1",
+        []() {
+            Logger::global().setDurability(GROUP_COMMIT, {ERROR});
+            Logger::global().setDurability(PERIODIC_SYNC, {INFO}, 10);
+        },
+        []() {
+            Logger::init();
+            uint64_t syncs = Logger::global().stats().syncs;
+
+            std::vector<std::thread> threads;
+            for (int i = 0; i < 8; i++) {
+                threads.emplace_back([i]() {
+                    for (int j = 0; j < 50; j++) {
+                        ERROR_LOG(FILE_ONLY, "thread ", i, " error ", j);
+                        INFO_LOG(FILE_ONLY, "thread ", i, " info ", j);
+                    }
+                });
+            }
+            for (auto &t: threads) {
+                t.join();
+            }
+            syncs = Logger::global().stats().syncs - syncs;
+
+            Logger::exit();
+
+            // ====================
+
+            // Le dossier logs est créé.
+            struct stat buffer{};
+            if (stat("logs", &buffer) != 0 || !S_ISDIR(buffer.st_mode)) {
+                return false;
+            }
+
+            // Il contient un seul fichier .log.
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            int nbFiles = 0;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    nbFiles++;
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            if (nbFiles != 1) {
+                return false;
+            }
+
+            // Le fichier .log contient 803 lignes de logs.
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            int nbLines = 0;
+            std::string line;
+            while (std::getline(file, line)) {
+                nbLines++;
+            }
+            file.close();
+            if (nbLines != 803) {
+                return false;
+            }
+
+            // Les logs ont fait des fdatasync.
+            if (syncs == 0) {
+                return false;
+            }
+
+            // Les 400 erreurs partagent leurs fdatasync.
+            bool tmpfs = false;
+#ifdef __linux__
+            struct statfs fs{};
+            tmpfs = statfs("logs", &fs) == 0 && fs.f_type == TMPFS_MAGIC;
+#endif
+            if (!tmpfs && syncs >= 400) {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            Logger::global().setDurability(NO_SYNC);
+            rmDir("logs");
+        }
+};
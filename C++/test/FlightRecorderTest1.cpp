@@ -0,0 +1,101 @@
+#include "test.h"
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test enregistreur 1 :
+ * Initialise le logger avec un enregistreur de 3 logs debug, log 5 fois en debug, 1 fois en info,
+ * 1 fois en erreur et exit le logger.
+ *
+ * Conditions de réussite :
+ * - Le dossier logs est créé.
+ * - Il contient un seul fichier .log.
+ * - Le fichier .log contient 9 lignes de logs.
+ * - La 3ème ligne est le log info.
+ * - Les 5ème à 7ème lignes sont les 3 derniers logs debug.
+ * - La 8ème ligne est le log erreur.
+ */
+Test FlightRecorderTest1 = {
+        "FlightRecorderTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger::init();
+            Logger::global().enableFlightRecorder(3, {DEBUG});
+
+            for (int i = 0; i < 5; i++) {
+                DEBUG_LOG(FILE_AND_CONSOLE, "debug ", i);
+            }
+            INFO_LOG(FILE_AND_CONSOLE, "info");
+            ERROR_LOG(FILE_AND_CONSOLE, "error");
+
+            Logger::global().disableFlightRecorder();
+            Logger::exit();
+
+            // ====================
+
+            // Le dossier logs est créé.
+            struct stat buffer{};
+            if (stat("logs", &buffer) != 0 || !S_ISDIR(buffer.st_mode)) {
+                return false;
+            }
+
+            // Il contient un seul fichier .log.
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            int nbFiles = 0;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    nbFiles++;
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            if (nbFiles != 1) {
+                return false;
+            }
+
+            // Le fichier .log contient 9 lignes de logs.
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+            if (lines.size() != 9) {
+                return false;
+            }
+
+            // La 3ème ligne est le log info.
+            if (lines[2].find("INFO") == std::string::npos || lines[2].find("info") == std::string::npos) {
+                return false;
+            }
+
+            // Les 5ème à 7ème lignes sont les 3 derniers logs debug.
+            for (int i = 0; i < 3; i++) {
+                if (lines[4 + i].find("DEBUG") == std::string::npos ||
+                    lines[4 + i].find("debug " + std::to_string(i + 2)) == std::string::npos) {
+                    return false;
+                }
+            }
+
+            // La 8ème ligne est le log erreur.
+            if (lines[7].find("ERROR") == std::string::npos || lines[7].find("error") == std::string::npos) {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
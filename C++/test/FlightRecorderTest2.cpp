@@ -0,0 +1,103 @@
+#include "test.h"
+#include <thread>
+#include <set>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test enregistreur 2 :
+ * Initialise un logger "recorder", lance 4 threads qui log chacun 2000 fois en debug et 20 fois en erreur
+ * pendant que le thread principal active et désactive l'enregistreur sans arrêt, puis ferme le logger.
+ *
+ * Conditions de réussite :
+ * - Le dossier logs contient un seul fichier .log.
+ * - Chaque ligne du fichier est un log complet, au format du fichier.
+ * - Les 80 logs erreur sont écrits.
+ * - Aucun log debug n'est écrit deux fois.
+ */
+Test FlightRecorderTest2 = {
+        "FlightRecorderTest2",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger logger("recorder");
+            logger.open(FILE_ONLY);
+
+            std::atomic<int> running(4);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; t++) {
+                threads.emplace_back([&logger, &running, t]() {
+                    for (int i = 0; i < 2000; i++) {
+                        DEBUG_LOG_TO(logger, FILE_ONLY, "debug ", t, " ", i);
+                        if (i % 100 == 0) {
+                            ERROR_LOG_TO(logger, FILE_ONLY, "error ", t, " ", i);
+                        }
+                    }
+                    running--;
+                });
+            }
+            int toggles = 0;
+            while (running.load() > 0 || toggles < 10) {
+                logger.enableFlightRecorder(16, {DEBUG});
+                logger.disableFlightRecorder();
+                toggles++;
+            }
+            for (auto &thread: threads) {
+                thread.join();
+            }
+
+            logger.close();
+
+            // ====================
+
+            // Le dossier logs contient un seul fichier .log.
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            int nbFiles = 0;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    nbFiles++;
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            if (nbFiles != 1) {
+                return false;
+            }
+
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            int errors = 0;
+            std::set<std::string> debugs;
+            std::string line;
+            while (std::getline(file, line)) {
+                // Chaque ligne du fichier est un log complet, au format du fichier.
+                if (line.empty() || line[0] != '[' || line.find("]\t[") == std::string::npos) {
+                    return false;
+                }
+                size_t content = line.rfind('\t');
+                std::string message = line.substr(content + 1);
+                if (message.compare(0, 6, "error ") == 0) {
+                    errors++;
+                } else if (message.compare(0, 6, "debug ") == 0) {
+                    // Aucun log debug n'est écrit deux fois.
+                    if (!debugs.insert(message).second) {
+                        return false;
+                    }
+                }
+            }
+
+            // Les 80 logs erreur sont écrits.
+            return errors == 80;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
@@ -0,0 +1,182 @@
+#include "test.h"
+#include <thread>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Un log généré : son numéro, son type, sa trace et sa phase
+ */
+struct GrepLog {
+    int i;
+    LoggerType type;
+    std::string trace;
+    int phase;
+};
+
+/**
+ * Contenus attendus des lignes des logs acceptés, continuations comprises
+ * @param logs std::vector<GrepLog>
+ * @param accepts bool(const GrepLog &)
+ * @return std::vector<std::string>
+ */
+template<typename F>
+static std::vector<std::string> expectedLines(const std::vector<GrepLog> &logs, F accepts) {
+    std::vector<std::string> res;
+    for (const auto &log: logs) {
+        if (!accepts(log)) {
+            continue;
+        }
+        res.push_back("Log " + std::to_string(log.i));
+        if (log.i % 2 == 1) {
+            res.push_back("continued " + std::to_string(log.i));
+            res.push_back("end " + std::to_string(log.i));
+        }
+    }
+    return res;
+}
+
+/**
+ * Contenus des lignes écrites par logger_grep, sans le préfixe des premières lignes
+ * @param output std::string
+ * @return std::vector<std::string>
+ */
+static std::vector<std::string> grepLines(const std::string &output) {
+    std::vector<std::string> res;
+    std::stringstream stream(output);
+    std::string line;
+    while (std::getline(stream, line)) {
+        size_t tab = line.rfind('\t');
+        res.push_back(tab == std::string::npos ? line : line.substr(tab + 1));
+    }
+    return res;
+}
+
+/**
+ * Test grep 1 :
+ * Initialise un logger "grep", fait 1500 logs de types et traces alternés, un sur deux sur 3 lignes,
+ * attend la seconde suivante, fait 1500 autres logs et ferme le logger.
+ * Cherche dans le fichier avec logger_grep, en morceaux de 4 Ko pour que des morceaux commencent
+ * par la suite d'un log.
+ *
+ * Conditions de réussite :
+ * - -e trouve toutes les lignes de suite, avec 1 et 4 threads.
+ * - -l et -T trouvent les logs de ces types et de cette trace, avec leurs lignes de suite.
+ * - -a et -b séparent les logs des deux phases.
+ * - -c compte les lignes trouvées.
+ * - Avec 4 threads et des morceaux de 4 Ko, la sortie est la même qu'avec 1 thread et un seul morceau.
+ */
+Test GrepTest1 = {
+        "GrepTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger logger("grep");
+            logger.open(FILE_ONLY);
+
+            const LoggerType types[] = {INFO, ERROR, WARNING};
+            std::vector<GrepLog> logs;
+            time_t middle = 0;
+            for (int i = 0; i < 3000; i++) {
+                if (i == 1500) {
+                    auto now = std::chrono::system_clock::now();
+                    middle = std::chrono::system_clock::to_time_t(now) + 1;
+                    std::this_thread::sleep_until(std::chrono::system_clock::from_time_t(middle) +
+                                                  std::chrono::milliseconds(10));
+                }
+                GrepLog log = {i, types[i % 3], i % 4 < 2 ? "alpha" : "beta", i < 1500 ? 1 : 2};
+                std::string message = "Log " + std::to_string(i);
+                if (i % 2 == 1) {
+                    message += "\ncontinued " + std::to_string(i) + "\nend " + std::to_string(i);
+                }
+                if (log.type == INFO) {
+                    logger.info(log.trace, FILE_ONLY, message);
+                } else if (log.type == ERROR) {
+                    logger.error(log.trace, FILE_ONLY, message);
+                } else {
+                    logger.warning(log.trace, FILE_ONLY, message);
+                }
+                logs.push_back(log);
+            }
+
+            logger.close();
+
+            // ====================
+
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string path;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    path = std::string("logs/") + ent->d_name;
+                }
+            }
+            closedir(dir);
+            if (path.empty()) {
+                return false;
+            }
+            char at[16];
+            struct tm local{};
+            localtime_r(&middle, &local);
+            strftime(at, sizeof(at), "%H:%M:%S", &local);
+            std::string pieces = " -p 4096 " + path;
+            std::string output;
+
+            // -e trouve toutes les lignes de suite, avec 1 et 4 threads.
+            std::vector<std::string> continued;
+            for (int i = 1; i < 3000; i += 2) {
+                continued.push_back("continued " + std::to_string(i));
+            }
+            for (const char *threads: {"-j 1", "-j 4"}) {
+                if (runTool(std::string("logger_grep -e continued ") + threads + pieces, output) != 0 ||
+                    grepLines(output) != continued) {
+                    return false;
+                }
+            }
+
+            // -l et -T trouvent les logs de ces types et de cette trace, avec leurs lignes de suite.
+            if (runTool("logger_grep -l ERROR,WARNING -T alpha -j 4" + pieces, output) != 0 ||
+                grepLines(output) != expectedLines(logs, [](const GrepLog &log) {
+                    return log.type != INFO && log.trace == "alpha";
+                })) {
+                return false;
+            }
+
+            // Avec 4 threads et des morceaux de 4 Ko, la sortie est la même qu'avec 1 thread et un seul morceau.
+            std::string single;
+            if (runTool("logger_grep -l ERROR,WARNING -T alpha -j 1 " + path, single) != 0 || single != output) {
+                return false;
+            }
+
+            // -a et -b séparent les logs des deux phases.
+            if (runTool("logger_grep -T beta -a " + std::string(at) + " -j 4" + pieces, output) != 0 ||
+                grepLines(output) != expectedLines(logs, [](const GrepLog &log) {
+                    return log.phase == 2 && log.trace == "beta";
+                })) {
+                return false;
+            }
+            if (runTool("logger_grep -l INFO -T alpha -b " + std::string(at) + " -j 4" + pieces, output) != 0 ||
+                grepLines(output) != expectedLines(logs, [](const GrepLog &log) {
+                    return log.phase == 1 && log.type == INFO && log.trace == "alpha";
+                })) {
+                return false;
+            }
+
+            // -c compte les lignes trouvées.
+            size_t alpha = expectedLines(logs, [](const GrepLog &log) {
+                return log.trace == "alpha";
+            }).size();
+            if (runTool("logger_grep -c -T alpha -j 4" + pieces, output) != 0 ||
+                output != std::to_string(alpha) + "\n") {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
@@ -0,0 +1,68 @@
+#include "test.h"
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test histogrammes 1 :
+ * Initialise le logger, active les histogrammes, log 100 fois en info dans le fichier
+ * et exit le logger.
+ *
+ * Conditions de réussite :
+ * - Les histogrammes de capture, de formatage, de verrou et d'écriture ont au moins 100 mesures.
+ * - Les percentiles sont ordonnés.
+ * - L'export contient une ligne par étape.
+ */
+Test HistogramTest1 = {
+        "HistogramTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger::init();
+            Logger::global().enableHistograms();
+
+            for (int i = 0; i < 100; i++) {
+                INFO_LOG(FILE_ONLY, "info ", i);
+            }
+
+            Logger::global().disableHistograms();
+            Logger::exit();
+
+            // ====================
+
+            std::vector<LoggerHistogram> histograms = Logger::global().histograms();
+            if (histograms.size() != SYNC_STAGE + 1) {
+                return false;
+            }
+
+            // Les histogrammes de capture, de formatage, de verrou et d'écriture ont au moins 100 mesures.
+            for (LoggerStage stage: {CAPTURE_STAGE, FORMAT_STAGE, LOCK_STAGE, WRITE_STAGE}) {
+                if (histograms[stage].count < 100) {
+                    return false;
+                }
+            }
+
+            // Les percentiles sont ordonnés.
+            const LoggerHistogram &format = histograms[FORMAT_STAGE];
+            if (format.percentile(0.5) > format.percentile(0.99) || format.percentile(0.5) == 0) {
+                return false;
+            }
+
+            // L'export contient une ligne par étape.
+            std::stringstream ss;
+            Logger::global().exportHistograms(ss);
+            int nbLines = 0;
+            std::string line;
+            while (std::getline(ss, line)) {
+                nbLines++;
+            }
+            if (nbLines != SYNC_STAGE + 1 || ss.str().find("\"stage\": \"format\"") == std::string::npos) {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
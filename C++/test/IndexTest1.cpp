@@ -0,0 +1,97 @@
+#include "test.h"
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test index 1 :
+ * Initialise un logger "index" avec un index de temps d'une entrée par Ko, fait 200 logs et ferme le logger.
+ *
+ * Conditions de réussite :
+ * - Le dossier logs contient le fichier .log et son index .log.idx.
+ * - L'index commence par LOGIDX01 et contient au moins 10 entrées.
+ * - Chaque entrée pointe sur le début de la ligne de son log, au moins 1 Ko après l'entrée précédente.
+ * - Les temps des entrées sont croissants.
+ */
+Test IndexTest1 = {
+        "IndexTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger logger("index");
+            logger.setTimeIndex(1);
+            logger.open(FILE_ONLY);
+
+            for (int i = 0; i < 200; i++) {
+                INFO_LOG_TO(logger, FILE_ONLY, "Message ", i, " long enough to fill the file quickly");
+            }
+
+            logger.close();
+
+            // ====================
+
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string logName;
+            std::string indexName;
+            while ((ent = readdir(dir)) != nullptr) {
+                std::string name = ent->d_name;
+                if (name.length() > 4 && name.substr(name.length() - 4) == ".idx") {
+                    indexName = name;
+                } else if (name != "." && name != "..") {
+                    logName = name;
+                }
+            }
+            closedir(dir);
+
+            // Le dossier logs contient le fichier .log et son index .log.idx.
+            if (logName.empty() || indexName != logName + ".idx") {
+                return false;
+            }
+
+            std::ifstream file("logs/" + logName, std::ios::binary);
+            std::string log((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            std::ifstream index("logs/" + indexName, std::ios::binary);
+            std::string data((std::istreambuf_iterator<char>(index)), std::istreambuf_iterator<char>());
+
+            // L'index commence par LOGIDX01 et contient au moins 10 entrées.
+            if (data.length() < 8 || data.compare(0, 8, "LOGIDX01") != 0 ||
+                (data.length() - 8) % sizeof(LoggerIndexEntry) != 0) {
+                return false;
+            }
+            std::vector<LoggerIndexEntry> entries((data.length() - 8) / sizeof(LoggerIndexEntry));
+            if (!entries.empty()) {
+                memcpy(entries.data(), data.data() + 8, data.length() - 8);
+            }
+            if (entries.size() < 10) {
+                return false;
+            }
+
+            for (size_t i = 0; i < entries.size(); i++) {
+                const LoggerIndexEntry &entry = entries[i];
+                // Chaque entrée pointe sur le début de la ligne de son log, au moins 1 Ko après l'entrée précédente.
+                if (entry.offset >= log.length() || (entry.offset > 0 && log[entry.offset - 1] != '\n')) {
+                    return false;
+                }
+                std::string start = "[" + std::to_string(entry.number) + "-";
+                if (log.compare(entry.offset, start.length(), start) != 0) {
+                    return false;
+                }
+                if (i > 0 && entry.offset < entries[i - 1].offset + 1024) {
+                    return false;
+                }
+                // Les temps des entrées sont croissants.
+                if (i > 0 && entry.time < entries[i - 1].time) {
+                    return false;
+                }
+            }
+
+            return true;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
@@ -0,0 +1,109 @@
+#include "test.h"
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test instances 1 :
+ * Initialise le logger par défaut et un second logger "audit" avec son propre format,
+ * log 3 fois avec le premier, 2 fois avec le second et ferme les deux loggers.
+ *
+ * Conditions de réussite :
+ * - Le dossier logs contient deux fichiers .log.
+ * - Le fichier du logger par défaut contient 6 lignes de logs, aucune du logger audit.
+ * - Le fichier du logger audit contient 4 lignes de logs, à son format et numérotées depuis 0.
+ * - Les compteurs du logger audit ne comptent que ses logs.
+ */
+Test InstanceTest1 = {
+        "InstanceTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger::init();
+
+            Logger audit("audit");
+            audit.setFileMode(DIRECT_FILE);
+            audit.setFormats("[%T]\t%C", "%n|%t|%C", "%C");
+            audit.open(FILE_ONLY);
+
+            for (int i = 0; i < 3; i++) {
+                INFO_LOG(FILE_ONLY, "global ", i);
+            }
+            for (int i = 0; i < 2; i++) {
+                INFO_LOG_TO(audit, FILE_ONLY, "audit ", i);
+            }
+
+            audit.close();
+            Logger::exit();
+
+            // ====================
+
+            // Le dossier logs contient deux fichiers .log.
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            int nbFiles = 0;
+            std::string globalName;
+            std::string auditName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    nbFiles++;
+                    if (strncmp(ent->d_name, "audit_", 6) == 0) {
+                        auditName = ent->d_name;
+                    } else {
+                        globalName = ent->d_name;
+                    }
+                }
+            }
+            closedir(dir);
+            if (nbFiles != 2 || auditName.empty() || globalName.empty()) {
+                return false;
+            }
+
+            // Le fichier du logger par défaut contient 6 lignes de logs, aucune du logger audit.
+            std::ifstream file("logs/" + globalName);
+            if (!file.is_open()) {
+                return false;
+            }
+            int nbLines = 0;
+            std::string line;
+            while (std::getline(file, line)) {
+                if (line.find("audit") != std::string::npos) {
+                    return false;
+                }
+                nbLines++;
+            }
+            file.close();
+            if (nbLines != 6) {
+                return false;
+            }
+
+            // Le fichier du logger audit contient 4 lignes de logs, à son format et numérotées depuis 0.
+            file.open("logs/" + auditName);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+            if (lines.size() != 4 || lines[0] != "0|INFO|Log start" || lines[1] != "1|INFO|audit 0" ||
+                lines[2] != "2|INFO|audit 1" || lines[3] != "3|INFO|End log") {
+                return false;
+            }
+
+            // Les compteurs du logger audit ne comptent que ses logs.
+            LoggerStats stats = audit.stats();
+            if (stats.messages[INFO] != 4 || stats.flushes != 4) {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
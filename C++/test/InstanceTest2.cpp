@@ -0,0 +1,130 @@
+#include "test.h"
+#include <thread>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Site limité partagé par les deux loggers du test
+ */
+static void logLimited(Logger &logger, int i) {
+    INFO_LOG_LIMITED_TO(logger, FILE_ONLY, 1, 2, "limited ", i);
+}
+
+/**
+ * Test instances 2 :
+ * Alloue un logger "heap" sur le tas, log avec les variantes _TO des macros limitées, échantillonnées,
+ * de module et clé-valeur, puis ferme et détruit le logger. Après 1,1 s, log depuis le même site limité vers un
+ * second logger "other" et le détruit.
+ *
+ * Conditions de réussite :
+ * - Le logger alloué est aligné comme alignof(Logger).
+ * - Le dossier logs contient un seul fichier .log, celui du logger heap.
+ * - Le fichier contient les 12 lignes attendues, dans l'ordre.
+ * - Le site limité écrit dans le logger other, le logger heap détruit n'est plus utilisé.
+ */
+Test InstanceTest2 = {
+        "InstanceTest2",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger *heap = new Logger("heap");
+            if ((uintptr_t) heap % alignof(Logger) != 0) {
+                delete heap;
+                return false;
+            }
+            heap->setFormats("[%T]\t%C", "%t|%C", "%C");
+            heap->open(FILE_ONLY);
+
+            for (int i = 0; i < 5; i++) {
+                logLimited(*heap, i);
+            }
+            for (int i = 0; i < 4; i++) {
+                WARNING_LOG_EVERY_N_TO(*heap, FILE_ONLY, 2, "every ", i);
+            }
+            DEBUG_LOG_SAMPLED_TO(*heap, FILE_ONLY, 1, "sampled");
+            DEBUG_LOG_SAMPLED_TO(*heap, FILE_ONLY, 0, "never");
+            Logger::setModuleTypes("heap.test", {ERROR});
+            INFO_LOG_MODULE_TO(*heap, "heap.test", FILE_ONLY, "hidden");
+            ERROR_LOG_MODULE_TO(*heap, "heap.test", FILE_ONLY, "module");
+            Logger::resetModuleTypes("heap.test");
+            SUCCESS_KV_TO(*heap, FILE_ONLY, "kv", "key", 1);
+            INFO_LOG_TO(*heap, FILE_ONLY, "last");
+
+            delete heap;
+
+            // ====================
+
+            // Le dossier logs contient un seul fichier .log, celui du logger heap.
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            int nbFiles = 0;
+            std::string heapName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    nbFiles++;
+                    if (strncmp(ent->d_name, "heap_", 5) == 0) {
+                        heapName = ent->d_name;
+                    }
+                }
+            }
+            closedir(dir);
+            if (nbFiles != 1 || heapName.empty()) {
+                return false;
+            }
+
+            // Le fichier contient les 12 lignes attendues, dans l'ordre.
+            std::ifstream file("logs/" + heapName);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+            std::vector<std::string> expected = {
+                    "INFO|Log start", "WARNING|Log directory created", "INFO|limited 0", "INFO|limited 1",
+                    "WARNING|every 0", "WARNING|every 2", "DEBUG|sampled", "ERROR|module", "SUCCESS|kv key=1",
+                    "INFO|last", "INFO|3 messages suppressed by rate limit", "INFO|End log"
+            };
+            if (lines != expected) {
+                return false;
+            }
+
+            // Le site limité écrit dans le logger other, le logger heap détruit n'est plus utilisé.
+            std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+            Logger *other = new Logger("other");
+            other->setFormats("[%T]\t%C", "%t|%C", "%C");
+            other->open(FILE_ONLY);
+            logLimited(*other, 5);
+            delete other;
+
+            dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            std::string otherName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strncmp(ent->d_name, "other_", 6) == 0) {
+                    otherName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            std::ifstream otherFile("logs/" + otherName);
+            lines.clear();
+            while (std::getline(otherFile, line)) {
+                lines.push_back(line);
+            }
+            expected = {"INFO|Log start", "INFO|limited 5", "INFO|End log"};
+
+            return lines == expected;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
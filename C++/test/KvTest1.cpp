@@ -0,0 +1,102 @@
+#include "test.h"
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test clé-valeur 1 :
+ * Initialise le logger et un logger "json" qui écrit son fichier en JSON, fait un log structuré avec chacun
+ * et ferme les deux loggers.
+ *
+ * Conditions de réussite :
+ * - Le fichier texte contient le message suivi des champs 'clé=valeur'.
+ * - Le fichier JSON contient 3 lignes, chacune un objet avec le numéro, l'heure, le type, la trace et le message.
+ * - Les champs du log structuré sont écrits avec leur type et les chaînes sont échappées.
+ */
+Test KvTest1 = {
+        "KvTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger::init();
+            Logger json("json");
+            json.setJsonFile(true);
+            json.open(FILE_ONLY);
+
+            INFO_KV(FILE_ONLY, "Request served", "user", 42, "ms", 3.5, "path", "/a\"b", "ok", true);
+            json.kv(WARNING, "serve", FILE_ONLY, "Line\nbreak", "user", -7, "ratio", 0.25, "name", std::string("\t"));
+
+            json.close();
+            Logger::exit();
+
+            // ====================
+
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string textName;
+            std::string jsonName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strncmp(ent->d_name, "json_", 5) == 0) {
+                    jsonName = ent->d_name;
+                } else if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    textName = ent->d_name;
+                }
+            }
+            closedir(dir);
+
+            // Le fichier texte contient le message suivi des champs 'clé=valeur'.
+            std::ifstream file("logs/" + textName);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+            std::string end = "\tRequest served user=42 ms=3.5 path=/a\"b ok=true";
+            if (lines.size() != 4 || lines[2].length() < end.length() ||
+                lines[2].compare(lines[2].length() - end.length(), end.length(), end) != 0) {
+                return false;
+            }
+
+            // Le fichier JSON contient 3 lignes, chacune un objet avec le numéro, l'heure, le type, la trace et le message.
+            file.open("logs/" + jsonName);
+            if (!file.is_open()) {
+                return false;
+            }
+            lines.clear();
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+            if (lines.size() != 3) {
+                return false;
+            }
+            for (int i = 0; i < 3; i++) {
+                std::string begin = "{\"seq\":" + std::to_string(i) + ",\"time\":\"";
+                if (lines[i].compare(0, begin.length(), begin) != 0 || lines[i][begin.length() + 10] != 'T' ||
+                    lines[i].compare(begin.length() + 29, 11, "\",\"level\":\"") != 0) {
+                    return false;
+                }
+            }
+            if (lines[0].substr(57) != "INFO\",\"trace\":\"open\",\"message\":\"Log start\"}") {
+                return false;
+            }
+
+            // Les champs du log structuré sont écrits avec leur type et les chaînes sont échappées.
+            if (lines[1].substr(57) !=
+                "WARNING\",\"trace\":\"serve\",\"message\":\"Line\\nbreak\",\"user\":-7,\"ratio\":0.25,\"name\":\"\\t\"}") {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
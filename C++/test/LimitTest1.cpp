@@ -0,0 +1,119 @@
+#include "test.h"
+#include <thread>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test limite 1 :
+ * Initialise le logger, log 1000 fois la même erreur depuis un site limité à 1 ligne par seconde (5 d'un coup),
+ * 1000 erreurs différentes depuis un autre site avec la même limite, 3 fois le même avertissement depuis un site
+ * limité à 20 lignes par seconde (5 d'un coup), une 4ème fois après 60 ms, et exit le logger.
+ *
+ * Conditions de réussite :
+ * - Le dossier logs est créé.
+ * - Il contient un seul fichier .log.
+ * - Le fichier .log contient 14 lignes de logs.
+ * - La 3ème ligne contient le message "fail", les 5 suivantes les 5 premières erreurs différentes.
+ * - La 9ème ligne contient "tick", la 10ème indique ses 3 répétitions, écrites sans attendre un autre message.
+ * - Les 995 erreurs différentes en trop sont supprimées par la limite.
+ * - Les 4 répétitions de "fail" gardées par la limite sont indiquées, les 995 suivantes sont supprimées.
+ */
+Test LimitTest1 = {
+        "LimitTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger::init();
+
+            for (int i = 0; i < 1000; i++) {
+                ERROR_LOG_LIMITED(FILE_AND_CONSOLE, 1, 5, "fail");
+            }
+            for (int i = 0; i < 1000; i++) {
+                ERROR_LOG_LIMITED(FILE_AND_CONSOLE, 1, 5, "fail ", i);
+            }
+            for (int i = 0; i < 4; i++) {
+                if (i == 3) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+                }
+                WARNING_LOG_LIMITED(FILE_AND_CONSOLE, 20, 5, "tick");
+            }
+
+            Logger::exit();
+
+            // ====================
+
+            // Le dossier logs est créé.
+            struct stat buffer{};
+            if (stat("logs", &buffer) != 0 || !S_ISDIR(buffer.st_mode)) {
+                return false;
+            }
+
+            // Il contient un seul fichier .log.
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            int nbFiles = 0;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    nbFiles++;
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            if (nbFiles != 1) {
+                return false;
+            }
+
+            // Le fichier .log contient 14 lignes de logs.
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+            if (lines.size() != 14) {
+                return false;
+            }
+
+            // La 3ème ligne contient le message "fail", les 5 suivantes les 5 premières erreurs différentes.
+            if (lines[2].find("fail") == std::string::npos || lines[2].find("ERROR") == std::string::npos) {
+                return false;
+            }
+            for (int i = 0; i < 5; i++) {
+                if (lines[3 + i].find("fail " + std::to_string(i)) == std::string::npos) {
+                    return false;
+                }
+            }
+
+            // La 9ème ligne contient "tick", la 10ème indique ses 3 répétitions, écrites sans attendre un autre message.
+            if (lines[8].find("tick") == std::string::npos ||
+                lines[9].find("Last message repeated 3 times") == std::string::npos) {
+                return false;
+            }
+
+            // Les 995 erreurs différentes en trop sont supprimées par la limite.
+            // Les 4 répétitions de "fail" gardées par la limite sont indiquées, les 995 suivantes sont supprimées.
+            int suppressed = 0;
+            bool repeated = false;
+            for (size_t i = 10; i < 13; i++) {
+                suppressed += lines[i].find("995 messages suppressed by rate limit") != std::string::npos;
+                repeated = repeated || lines[i].find("Last message repeated 4 times") != std::string::npos;
+            }
+            if (suppressed != 2 || !repeated) {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
@@ -0,0 +1,82 @@
+#include "test.h"
+#include <ctime>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Accès aux conversions internes du logger
+ */
+class LoggerTest {
+public:
+    static void localTime(time_t seconds, struct tm &res) {
+        Logger::localTime(seconds, res);
+    }
+};
+
+/**
+ * Test heure locale 1 :
+ * Pour 4 fuseaux horaires, dont America/St_Johns qui changeait d'heure à 00:01, cherche les changements d'heure
+ * de 1970 à 2030 et convertit chaque seconde des 20 minutes autour de chacun.
+ *
+ * Conditions de réussite :
+ * - Des changements d'heure sont trouvés.
+ * - La date et l'heure du logger sont celles de localtime_r pour chaque seconde.
+ */
+Test LocalTimeTest1 = {
+        "LocalTimeTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            const char *previous = getenv("TZ");
+            std::string saved = previous != nullptr ? previous : "";
+            bool result = true;
+            int transitions = 0;
+
+            for (const char *zone: {"America/St_Johns", "Europe/Paris", "Australia/Lord_Howe", "Asia/Kathmandu"}) {
+                setenv("TZ", zone, 1);
+                tzset();
+
+                struct tm before{};
+                time_t t = 0;
+                localtime_r(&t, &before);
+                for (; t < (time_t) 1893456000 && result; t += 3600) {
+                    struct tm after{};
+                    time_t next = t + 3600;
+                    localtime_r(&next, &after);
+                    if (after.tm_gmtoff == before.tm_gmtoff) {
+                        continue;
+                    }
+                    before = after;
+                    transitions++;
+
+                    // La date et l'heure du logger sont celles de localtime_r pour chaque seconde.
+                    for (time_t s = t - 600; s < next + 600; s++) {
+                        struct tm expected{};
+                        struct tm res{};
+                        localtime_r(&s, &expected);
+                        LoggerTest::localTime(s, res);
+                        if (res.tm_year != expected.tm_year || res.tm_mon != expected.tm_mon ||
+                            res.tm_mday != expected.tm_mday || res.tm_hour != expected.tm_hour ||
+                            res.tm_min != expected.tm_min || res.tm_sec != expected.tm_sec) {
+                            result = false;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            if (previous != nullptr) {
+                setenv("TZ", saved.c_str(), 1);
+            } else {
+                unsetenv("TZ");
+            }
+            tzset();
+
+            // Des changements d'heure sont trouvés.
+            return result && transitions > 0;
+        },
+        []() {
+            // Do nothing
+        }
+};
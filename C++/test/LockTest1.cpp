@@ -0,0 +1,104 @@
+#include "test.h"
+#include <thread>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test verrou 1 :
+ * Initialise le logger, active le profil du mutex et l'attente active, lance 4 threads qui log chacun 200 fois
+ * en info dans le fichier et exit le logger après avoir join les threads.
+ *
+ * Conditions de réussite :
+ * - Le fichier .log contient 803 lignes de logs.
+ * - Le mutex compte au moins 800 acquisitions.
+ * - Les attentes des sites d'appel correspondent aux acquisitions contendues.
+ * - L'export contient le profil.
+ */
+Test LockTest1 = {
+        "LockTest1",
+        []() {
+            Logger::global().setLockProfiling(true);
+            Logger::global().setLockSpinning(true);
+        },
+        []() {
+            LoggerLockStats before = Logger::global().lockStats();
+
+            Logger::init();
+
+            std::vector<std::thread> threads;
+            for (int i = 0; i < 4; i++) {
+                threads.emplace_back([i]() {
+                    for (int j = 0; j < 200; j++) {
+                        INFO_LOG(FILE_ONLY, "thread ", i, " line ", j);
+                    }
+                });
+            }
+            for (auto &t: threads) {
+                t.join();
+            }
+
+            Logger::exit();
+
+            LoggerLockStats after = Logger::global().lockStats();
+
+            // ====================
+
+            // Le fichier .log contient 803 lignes de logs.
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            int nbLines = 0;
+            std::string line;
+            while (std::getline(file, line)) {
+                nbLines++;
+            }
+            file.close();
+            if (nbLines != 803) {
+                return false;
+            }
+
+            // Le mutex compte au moins 800 acquisitions.
+            if (after.acquisitions - before.acquisitions < 800) {
+                return false;
+            }
+
+            // Les attentes des sites d'appel correspondent aux acquisitions contendues.
+            uint64_t waits = 0;
+            for (const auto &site: after.sites) {
+                waits += site.waits;
+            }
+            for (const auto &site: before.sites) {
+                waits -= site.waits;
+            }
+            if (waits != after.contended - before.contended) {
+                return false;
+            }
+
+            // L'export contient le profil.
+            std::stringstream ss;
+            Logger::global().exportLockProfile(ss);
+            if (ss.str().find("\"acquisitions\": " + std::to_string(after.acquisitions)) == std::string::npos) {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            Logger::global().setLockProfiling(false);
+            Logger::global().setLockSpinning(false);
+            rmDir("logs");
+        }
+};
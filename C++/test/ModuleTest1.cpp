@@ -0,0 +1,101 @@
+#include "test.h"
+
+#include "../logger/Logger.hpp"
+
+static int evaluated = 0;
+
+static int evaluate() {
+    return ++evaluated;
+}
+
+/**
+ * Test modules 1 :
+ * Donne les types ERROR au module "net" et INFO, ERROR au module "net.http", initialise le logger,
+ * log en info depuis "net.http", "net.tcp" et "db.pool", rend au module "net.http" les types de "net",
+ * donne le type INFO à "net.tcp", log à nouveau depuis les mêmes sites et exit le logger.
+ *
+ * Conditions de réussite :
+ * - Le fichier .log contient 7 lignes de logs.
+ * - Chaque module n'écrit que les types qu'il a ou qu'il hérite, avant et après le changement.
+ * - Les arguments des logs ignorés ne sont pas évalués.
+ * - Le module "net.http" hérite des types de "net".
+ */
+Test ModuleTest1 = {
+        "ModuleTest1",
+        []() {
+            evaluated = 0;
+            Logger::setModuleTypes("net", {ERROR});
+            Logger::setModuleTypes("net.http", {INFO, ERROR});
+        },
+        []() {
+            Logger::init();
+
+            for (int i = 0; i < 2; i++) {
+                INFO_LOG_MODULE("net.http", FILE_ONLY, "http ", i);
+                INFO_LOG_MODULE("net.tcp", FILE_ONLY, "tcp ", i, " ", evaluate());
+                INFO_LOG_MODULE("db.pool", FILE_ONLY, "db ", i);
+
+                Logger::resetModuleTypes("net.http");
+                Logger::setModuleTypes("net.tcp", {INFO});
+            }
+
+            Logger::exit();
+
+            // ====================
+
+            // Le fichier .log contient 7 lignes de logs.
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+            if (lines.size() != 7) {
+                return false;
+            }
+
+            // Chaque module n'écrit que les types qu'il a ou qu'il hérite, avant et après le changement.
+            const char *expected[] = {"http 0", "db 0", "tcp 1 1", "db 1"};
+            for (int i = 0; i < 4; i++) {
+                std::string end = std::string("\t") + expected[i];
+                if (lines[i + 2].length() < end.length() ||
+                    lines[i + 2].compare(lines[i + 2].length() - end.length(), end.length(), end) != 0) {
+                    return false;
+                }
+            }
+
+            // Les arguments des logs ignorés ne sont pas évalués.
+            if (evaluated != 1) {
+                return false;
+            }
+
+            // Le module "net.http" hérite des types de "net".
+            std::vector<LoggerType> types = Logger::getModuleTypes("net.http");
+            if (types.size() != 1 || types[0] != ERROR) {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            Logger::resetModuleTypes("net");
+            Logger::resetModuleTypes("net.tcp");
+            rmDir("logs");
+        }
+};
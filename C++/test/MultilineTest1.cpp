@@ -0,0 +1,82 @@
+#include "test.h"
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test multiligne 1 :
+ * Initialise un logger "multi" qui répète le préfixe sur chaque ligne, log un message de 3 lignes
+ * et un message d'une ligne, puis ferme le logger.
+ *
+ * Conditions de réussite :
+ * - Le fichier .log contient 7 lignes de logs.
+ * - Chaque ligne du message multiligne commence par le même préfixe (numéro, heure, type et trace).
+ * - Le message d'une ligne a le numéro suivant.
+ */
+Test MultilineTest1 = {
+        "MultilineTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger multi("multi");
+            multi.setMultiline(true);
+            multi.open(FILE_ONLY);
+
+            INFO_LOG_TO(multi, FILE_ONLY, "Stack trace :\n  at main\n  at start");
+            INFO_LOG_TO(multi, FILE_ONLY, "One line");
+
+            multi.close();
+
+            // ====================
+
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+
+            // Le fichier .log contient 7 lignes de logs.
+            if (lines.size() != 7) {
+                return false;
+            }
+
+            // Chaque ligne du message multiligne commence par le même préfixe (numéro, heure, type et trace).
+            size_t prefix = lines[2].find("]\t") + 2;
+            prefix = lines[2].find("]\t", prefix) + 2;
+            if (lines[2].substr(prefix) != "Stack trace :" || lines[3].substr(prefix) != "  at main" ||
+                lines[4].substr(prefix) != "  at start") {
+                return false;
+            }
+            if (lines[3].compare(0, prefix, lines[2], 0, prefix) != 0 ||
+                lines[4].compare(0, prefix, lines[2], 0, prefix) != 0) {
+                return false;
+            }
+
+            // Le message d'une ligne a le numéro suivant.
+            if (lines[5].compare(0, 3, "[3-") != 0 || lines[5].substr(lines[5].length() - 8) != "One line") {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
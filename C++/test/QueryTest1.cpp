@@ -0,0 +1,119 @@
+#include "test.h"
+#include <thread>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Attend le début de la seconde suivante
+ * @return time_t La seconde commencée
+ */
+static time_t nextSecond() {
+    auto now = std::chrono::system_clock::now();
+    time_t second = std::chrono::system_clock::to_time_t(now) + 1;
+    std::this_thread::sleep_until(std::chrono::system_clock::from_time_t(second) + std::chrono::milliseconds(10));
+    return second;
+}
+
+/**
+ * Test requête 1 :
+ * Initialise un logger "query" au format par défaut avec un index de temps d'une entrée par Ko, fait 300 logs,
+ * attend la seconde suivante, fait 300 logs, attend la seconde suivante, fait 300 logs et ferme le logger.
+ * Lit avec logger_query l'intervalle entre le début des deux secondes attendues.
+ *
+ * Conditions de réussite :
+ * - logger_query réussit.
+ * - Sa sortie est une suite de lignes entières du fichier.
+ * - Elle contient exactement les 300 logs de l'intervalle.
+ */
+Test QueryTest1 = {
+        "QueryTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger logger("query");
+            logger.setTimeIndex(1);
+            logger.open(FILE_ONLY);
+
+            time_t from = 0;
+            time_t to = 0;
+            for (int phase = 1; phase <= 3; phase++) {
+                if (phase == 2) {
+                    from = nextSecond();
+                } else if (phase == 3) {
+                    to = nextSecond();
+                }
+                for (int i = 0; i < 300; i++) {
+                    INFO_LOG_TO(logger, FILE_ONLY, "Phase ", phase, " log ", i, " long enough to fill the index");
+                }
+            }
+
+            logger.close();
+
+            // ====================
+
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string logName;
+            while ((ent = readdir(dir)) != nullptr) {
+                std::string name = ent->d_name;
+                if (name.length() > 4 && name.substr(name.length() - 4) == ".log") {
+                    logName = name;
+                }
+            }
+            closedir(dir);
+            std::ifstream file("logs/" + logName);
+            if (logName.empty() || !file.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+
+            // logger_query réussit.
+            char range[2][32];
+            time_t times[2] = {from, to};
+            for (int i = 0; i < 2; i++) {
+                struct tm local{};
+                localtime_r(&times[i], &local);
+                strftime(range[i], sizeof(range[i]), "%Y-%m-%d %H:%M:%S", &local);
+            }
+            std::string output;
+            if (runTool("logger_query logs/" + logName + " '" + range[0] + "' '" + range[1] + "'", output) != 0) {
+                return false;
+            }
+
+            // Sa sortie est une suite de lignes entières du fichier.
+            std::vector<std::string> queried;
+            std::stringstream stream(output);
+            while (std::getline(stream, line)) {
+                queried.push_back(line);
+            }
+            if (queried.empty() || output[output.length() - 1] != '\n') {
+                return false;
+            }
+            auto first = std::find(lines.begin(), lines.end(), queried[0]);
+            if (first == lines.end() || (size_t) (lines.end() - first) < queried.size() ||
+                !std::equal(queried.begin(), queried.end(), first)) {
+                return false;
+            }
+
+            // Elle contient exactement les 300 logs de l'intervalle.
+            int inside = 0;
+            for (const auto &l: queried) {
+                if (l.find("\tPhase 2 log ") != std::string::npos) {
+                    inside++;
+                }
+            }
+            return inside == 300 && queried.size() == 300;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
@@ -0,0 +1,99 @@
+#include "test.h"
+
+#include "../logger/Logger.hpp"
+
+static int evaluated = 0;
+
+static int evaluate() {
+    return ++evaluated;
+}
+
+/**
+ * Test échantillonnage 1 :
+ * Initialise le logger, log 100 fois en info une ligne sur 10, 100 fois en debug avec une probabilité de 0,
+ * 5 fois en debug avec une probabilité de 1, 5 fois en info une ligne sur n avec n = 0 calculé à l'exécution
+ * et exit le logger.
+ *
+ * Conditions de réussite :
+ * - Le dossier logs est créé.
+ * - Il contient un seul fichier .log.
+ * - Le fichier .log contient 23 lignes de logs.
+ * - Les arguments des logs ignorés ne sont pas évalués.
+ */
+Test SamplingTest1 = {
+        "SamplingTest1",
+        []() {
+            evaluated = 0;
+        },
+        []() {
+            Logger::init();
+
+            for (int i = 0; i < 100; i++) {
+                INFO_LOG_EVERY_N(FILE_AND_CONSOLE, 10, "Iteration ", i);
+            }
+            for (int i = 0; i < 100; i++) {
+                DEBUG_LOG_SAMPLED(FILE_AND_CONSOLE, 0, "Evaluated ", evaluate());
+            }
+            for (int i = 0; i < 5; i++) {
+                DEBUG_LOG_SAMPLED(FILE_AND_CONSOLE, 1, "Iteration ", i);
+            }
+            int every = evaluated;
+            for (int i = 0; i < 5; i++) {
+                INFO_LOG_EVERY_N(FILE_AND_CONSOLE, every, "Iteration ", i);
+            }
+
+            Logger::exit();
+
+            // ====================
+
+            // Le dossier logs est créé.
+            struct stat buffer{};
+            if (stat("logs", &buffer) != 0 || !S_ISDIR(buffer.st_mode)) {
+                return false;
+            }
+
+            // Il contient un seul fichier .log.
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            int nbFiles = 0;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    nbFiles++;
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            if (nbFiles != 1) {
+                return false;
+            }
+
+            // Le fichier .log contient 23 lignes de logs.
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            int nbLines = 0;
+            std::string line;
+            while (std::getline(file, line)) {
+                nbLines++;
+            }
+            file.close();
+            if (nbLines != 23) {
+                return false;
+            }
+
+            // Les arguments des logs ignorés ne sont pas évalués.
+            if (evaluated != 0) {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
@@ -0,0 +1,79 @@
+#include "test.h"
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test nettoyage 1 :
+ * Active le nettoyage des messages, initialise le logger, log un message avec une séquence ANSI,
+ * une tabulation, un retour à la ligne et un octet UTF-8 invalide, puis un message propre avec des accents,
+ * et exit le logger.
+ *
+ * Conditions de réussite :
+ * - Le fichier .log contient 5 lignes de logs.
+ * - Les caractères de contrôle et l'UTF-8 invalide du premier message sont échappés.
+ * - Le message propre est écrit tel quel.
+ */
+Test SanitizeTest1 = {
+        "SanitizeTest1",
+        []() {
+            Logger::global().setSanitize(true);
+        },
+        []() {
+            Logger::init();
+
+            INFO_LOG(FILE_ONLY, "a\x1b[31mred\tb\nc\xff");
+            INFO_LOG(FILE_ONLY, "Un message propre et assez long pour être lu par blocs de 32 octets, déjà vu");
+
+            Logger::exit();
+
+            // ====================
+
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+
+            // Le fichier .log contient 5 lignes de logs.
+            if (lines.size() != 5) {
+                return false;
+            }
+
+            // Les caractères de contrôle et l'UTF-8 invalide du premier message sont échappés.
+            std::string end = "\ta\\x1b[31mred\\tb\\nc\\xff";
+            if (lines[2].length() < end.length() ||
+                lines[2].compare(lines[2].length() - end.length(), end.length(), end) != 0) {
+                return false;
+            }
+
+            // Le message propre est écrit tel quel.
+            end = "\tUn message propre et assez long pour être lu par blocs de 32 octets, déjà vu";
+            if (lines[3].length() < end.length() ||
+                lines[3].compare(lines[3].length() - end.length(), end.length(), end) != 0) {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            Logger::global().setSanitize(false);
+            rmDir("logs");
+        }
+};
@@ -0,0 +1,121 @@
+#include "test.h"
+#include <thread>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test shard 1 :
+ * Initialise un logger "shard" qui écrit 4 fichiers (SHARDED_FILE), lance 4 threads qui font chacun 100 logs,
+ * fait un log de 2 lignes, ferme le logger puis fusionne les fichiers.
+ *
+ * Conditions de réussite :
+ * - Le dossier logs contient entre 2 et 4 fichiers.
+ * - Chaque ligne des fichiers commence par le numéro du log et le temps, et les numéros d'un fichier sont croissants.
+ * - La fusion contient les 404 logs dans l'ordre de leur numéro, sans numéro ni temps devant.
+ * - La 2ème ligne du log de 2 lignes suit la 1ère.
+ */
+Test ShardTest1 = {
+        "ShardTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger logger("shard");
+            logger.setFileMode(SHARDED_FILE);
+            logger.setFileShards(4);
+            logger.open(FILE_ONLY);
+
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; t++) {
+                threads.emplace_back([&logger, t]() {
+                    for (int i = 0; i < 100; i++) {
+                        INFO_LOG_TO(logger, FILE_ONLY, "Thread ", t, " log ", i);
+                    }
+                });
+            }
+            for (auto &thread: threads) {
+                thread.join();
+            }
+            INFO_LOG_TO(logger, FILE_ONLY, "First line\nSecond line");
+
+            logger.close();
+
+            // ====================
+
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::vector<std::string> paths;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    paths.push_back(std::string("logs/") + ent->d_name);
+                }
+            }
+            closedir(dir);
+
+            // Le dossier logs contient entre 2 et 4 fichiers.
+            if (paths.size() < 2 || paths.size() > 4) {
+                return false;
+            }
+
+            // Chaque ligne des fichiers commence par le numéro du log et le temps, et les numéros d'un fichier sont croissants.
+            for (const auto &path: paths) {
+                std::ifstream file(path);
+                if (!file.is_open()) {
+                    return false;
+                }
+                std::string line;
+                long long last = -1;
+                while (std::getline(file, line)) {
+                    if (line == "Second line") {
+                        continue;
+                    }
+                    size_t tab = line.find('\t');
+                    size_t second = line.find('\t', tab + 1);
+                    if (tab == std::string::npos || second == std::string::npos) {
+                        return false;
+                    }
+                    long long number = atoll(line.c_str());
+                    if (number <= last) {
+                        return false;
+                    }
+                    last = number;
+                }
+            }
+
+            // La fusion contient les 404 logs dans l'ordre de leur numéro, sans numéro ni temps devant.
+            std::stringstream merged;
+            if (!Logger::mergeShards(paths, merged)) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(merged, line)) {
+                lines.push_back(line);
+            }
+            if (lines.size() != 405) {
+                return false;
+            }
+            int number = 0;
+            for (size_t i = 0; i < lines.size(); i++) {
+                if (lines[i] == "Second line") {
+                    // La 2ème ligne du log de 2 lignes suit la 1ère.
+                    if (i == 0 || lines[i - 1].substr(lines[i - 1].length() - 10) != "First line") {
+                        return false;
+                    }
+                    continue;
+                }
+                if (lines[i].compare(0, std::to_string(number).length() + 2, "[" + std::to_string(number) + "-") != 0) {
+                    return false;
+                }
+                number++;
+            }
+
+            return number == 404;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
@@ -0,0 +1,119 @@
+#include "test.h"
+#include <thread>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test shard 2 :
+ * Initialise un logger "shards" qui écrit 2 fichiers (SHARDED_FILE), lance 8 threads qui font chacun 500 logs,
+ * plus de threads que de fichiers, ferme le logger puis fusionne les fichiers.
+ *
+ * Conditions de réussite :
+ * - Le dossier logs contient 2 fichiers.
+ * - Les temps d'un fichier sont croissants.
+ * - La fusion contient les 4003 logs dans l'ordre de leur numéro.
+ * - Les logs de chaque thread sont dans leur ordre.
+ */
+Test ShardTest2 = {
+        "ShardTest2",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger logger("shards");
+            logger.setFileMode(SHARDED_FILE);
+            logger.setFileShards(2);
+            logger.open(FILE_ONLY);
+
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 8; t++) {
+                threads.emplace_back([&logger, t]() {
+                    for (int i = 0; i < 500; i++) {
+                        INFO_LOG_TO(logger, FILE_ONLY, "Thread ", t, " log ", i);
+                    }
+                });
+            }
+            for (auto &thread: threads) {
+                thread.join();
+            }
+
+            logger.close();
+
+            // ====================
+
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::vector<std::string> paths;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    paths.push_back(std::string("logs/") + ent->d_name);
+                }
+            }
+            closedir(dir);
+
+            // Le dossier logs contient 2 fichiers.
+            if (paths.size() != 2) {
+                return false;
+            }
+
+            // Les temps d'un fichier sont croissants.
+            for (const auto &path: paths) {
+                std::ifstream file(path);
+                if (!file.is_open()) {
+                    return false;
+                }
+                std::string line;
+                long long last = 0;
+                while (std::getline(file, line)) {
+                    size_t tab = line.find('\t');
+                    if (tab == std::string::npos) {
+                        return false;
+                    }
+                    long long time = atoll(line.c_str() + tab + 1);
+                    if (time < last) {
+                        return false;
+                    }
+                    last = time;
+                }
+            }
+
+            // La fusion contient les 4003 logs dans l'ordre de leur numéro.
+            std::stringstream merged;
+            if (!Logger::mergeShards(paths, merged)) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(merged, line)) {
+                lines.push_back(line);
+            }
+            if (lines.size() != 4003) {
+                return false;
+            }
+            std::vector<int> next(8, 0);
+            for (size_t i = 0; i < lines.size(); i++) {
+                if (lines[i].compare(0, std::to_string(i).length() + 2, "[" + std::to_string(i) + "-") != 0) {
+                    return false;
+                }
+                // Les logs de chaque thread sont dans leur ordre.
+                size_t thread = lines[i].find("Thread ");
+                if (thread == std::string::npos) {
+                    continue;
+                }
+                int t = atoi(lines[i].c_str() + thread + 7);
+                int log = atoi(lines[i].c_str() + lines[i].find(" log ") + 5);
+                if (t < 0 || t >= 8 || log != next[t]) {
+                    return false;
+                }
+                next[t]++;
+            }
+
+            return true;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
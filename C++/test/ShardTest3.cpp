@@ -0,0 +1,62 @@
+#include "test.h"
+#include "counters.h"
+#include <thread>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test shard 3 :
+ * Initialise un logger "durable" qui écrit 2 fichiers (SHARDED_FILE), lance 4 threads qui font chacun 250 logs
+ * en PERIODIC_SYNC d'une heure, fait 100 erreurs en GROUP_COMMIT puis ferme le logger.
+ *
+ * Conditions de réussite :
+ * - Les logs en PERIODIC_SYNC font au plus 1 fdatasync par fichier.
+ * - Les erreurs en GROUP_COMMIT font au plus 1 fdatasync par log.
+ * - La fermeture synchronise chaque fichier.
+ */
+Test ShardTest3 = {
+        "ShardTest3",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger logger("durable");
+            logger.setFileMode(SHARDED_FILE);
+            logger.setFileShards(2);
+            logger.open(FILE_ONLY);
+            logger.setDurability(PERIODIC_SYNC, {INFO}, 3600000);
+            logger.setDurability(GROUP_COMMIT, {ERROR});
+
+            // Les logs en PERIODIC_SYNC font au plus 1 fdatasync par fichier.
+            uint64_t before = syncCount.load();
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; t++) {
+                threads.emplace_back([&logger, t]() {
+                    for (int i = 0; i < 250; i++) {
+                        INFO_LOG_TO(logger, FILE_ONLY, "Thread ", t, " log ", i);
+                    }
+                });
+            }
+            for (auto &thread: threads) {
+                thread.join();
+            }
+            uint64_t periodic = syncCount.load() - before;
+
+            // Les erreurs en GROUP_COMMIT font au plus 1 fdatasync par log.
+            before = syncCount.load();
+            for (int i = 0; i < 100; i++) {
+                ERROR_LOG_TO(logger, FILE_ONLY, "Error ", i);
+            }
+            uint64_t grouped = syncCount.load() - before;
+
+            // La fermeture synchronise chaque fichier.
+            before = syncCount.load();
+            logger.close();
+            uint64_t closing = syncCount.load() - before;
+
+            return periodic >= 1 && periodic <= 2 && grouped >= 1 && grouped <= 100 && closing == 2;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
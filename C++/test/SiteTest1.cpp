@@ -0,0 +1,166 @@
+#include "test.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "../logger/Logger.hpp"
+
+static int evaluated = 0;
+
+static int evaluate() {
+    return ++evaluated;
+}
+
+static const int SECOND_LINE = __LINE__ + 4;
+
+static void debugSites(int i) {
+    DEBUG_LOG(FILE_ONLY, "first ", i);
+    DEBUG_LOG(FILE_ONLY, "second ", i, " ", evaluate());
+}
+
+static void debugOther(int i) {
+    DEBUG_LOG(FILE_ONLY, "other ", i, " ", evaluate());
+    DEBUG_LOG_TO(Logger::global(), FILE_ONLY, "other to ", i, " ", evaluate());
+    DEBUG_KV(FILE_ONLY, "other kv", "i", i, "n", evaluate());
+}
+
+static std::string control(const std::string &command) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, "logger.sock", sizeof(address.sun_path) - 1);
+    if (connect(fd, (struct sockaddr *) &address, sizeof(address)) != 0) {
+        close(fd);
+        return "";
+    }
+
+    std::string answer;
+    if (write(fd, command.c_str(), command.length()) == (ssize_t) command.length()) {
+        char c;
+        while (read(fd, &c, 1) == 1 && c != '\n') {
+            answer += c;
+        }
+    }
+    close(fd);
+
+    return answer;
+}
+
+/**
+ * Test sites 1 :
+ * Vérifie que la socket de contrôle ne remplace pas un fichier ordinaire,
+ * désactive les sites de la fonction debugOther (DEBUG_LOG, DEBUG_LOG_TO et DEBUG_KV) avant leur premier appel, initialise le logger,
+ * appelle debugSites et debugOther, désactive le second site de debugSites par son fichier et sa ligne,
+ * les appelle à nouveau, réactive debugOther par la socket de contrôle, les appelle une dernière fois
+ * et exit le logger.
+ *
+ * Conditions de réussite :
+ * - Un fichier ordinaire à la place de la socket est gardé, la socket créée n'est accessible qu'à l'utilisateur.
+ * - La règle sur debugOther s'applique au site enregistré après elle.
+ * - La désactivation par fichier et ligne ne touche qu'un site.
+ * - La socket de contrôle répond le nombre de sites touchés.
+ * - Le fichier .log contient 10 lignes de logs, seulement celles des sites actifs.
+ * - Les arguments des sites désactivés ne sont pas évalués.
+ */
+Test SiteTest1 = {
+        "SiteTest1",
+        []() {
+            evaluated = 0;
+        },
+        []() {
+            // Un fichier ordinaire à la place de la socket est gardé, la socket créée n'est accessible qu'à l'utilisateur.
+            {
+                std::ofstream regular("logger.sock");
+                regular << "keep" << std::endl;
+            }
+            struct stat status{};
+            if (Logger::openSiteControl("logger.sock") || stat("logger.sock", &status) != 0 ||
+                !S_ISREG(status.st_mode)) {
+                return false;
+            }
+            remove("logger.sock");
+
+            Logger::disableSites("debugOther");
+            if (!Logger::openSiteControl("logger.sock")) {
+                return false;
+            }
+            if (lstat("logger.sock", &status) != 0 || !S_ISSOCK(status.st_mode) || (status.st_mode & 0777) != 0600) {
+                return false;
+            }
+            Logger::init();
+
+            debugSites(0);
+            debugOther(0);
+
+            // La désactivation par fichier et ligne ne touche qu'un site.
+            if (Logger::disableSites("*SiteTest1.cpp:" + std::to_string(SECOND_LINE)) != 1) {
+                return false;
+            }
+
+            debugSites(1);
+            debugOther(1);
+
+            // La socket de contrôle répond le nombre de sites touchés.
+            if (control("+debugOther\n") != "3") {
+                return false;
+            }
+
+            debugSites(2);
+            debugOther(2);
+
+            Logger::exit();
+            Logger::closeSiteControl();
+
+            // ====================
+
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+
+            // Le fichier .log contient 10 lignes de logs, seulement celles des sites actifs.
+            // La règle sur debugOther s'applique au site enregistré après elle.
+            if (lines.size() != 10) {
+                return false;
+            }
+            const char *expected[] = {"first 0", "second 0 1", "first 1", "first 2", "other 2 2", "other to 2 3",
+                                      "other kv i=2 n=4"};
+            for (int i = 0; i < 7; i++) {
+                std::string end = std::string("\t") + expected[i];
+                if (lines[i + 2].length() < end.length() ||
+                    lines[i + 2].compare(lines[i + 2].length() - end.length(), end.length(), end) != 0) {
+                    return false;
+                }
+            }
+
+            // Les arguments des sites désactivés ne sont pas évalués.
+            if (evaluated != 4) {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            Logger::closeSiteControl();
+            Logger::enableSites("*");
+            remove("logger.sock");
+            rmDir("logs");
+        }
+};
@@ -0,0 +1,137 @@
+#include "test.h"
+#include <thread>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test span 1 :
+ * Initialise le logger et ouvre un fichier de trace, lance 2 threads qui ouvrent chacun un span
+ * contenant un span imbriqué et un span de trace seule, puis ferme la trace, ouvre un dernier span de trace seule
+ * et exit le logger après avoir join les threads.
+ *
+ * Conditions de réussite :
+ * - Le fichier .log contient 4 logs de durée ('took ... us'), aucun des spans de trace seule.
+ * - Le fichier de trace est un tableau JSON qui commence par le nom du processus et contient 6 événements complets.
+ * - 4 événements sont imbriqués (profondeur 1), dont les 2 spans de trace seule.
+ * - Les événements des 2 threads ont 2 identifiants de thread différents.
+ */
+Test SpanTest1 = {
+        "SpanTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger::init();
+            if (!Logger::global().openTrace("logger.trace.json")) {
+                Logger::exit();
+                return false;
+            }
+
+            auto work = []() {
+                LOG_SCOPE_TIMER(FILE_ONLY, "request");
+                {
+                    LOG_SCOPE_TIMER(FILE_ONLY, "parse");
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                {
+                    LOG_SCOPE_TRACE("decode");
+                }
+            };
+            std::thread t1(work);
+            std::thread t2(work);
+            t1.join();
+            t2.join();
+
+            Logger::global().closeTrace();
+            {
+                LOG_SCOPE_TRACE("ignored");
+            }
+            Logger::exit();
+
+            // ====================
+
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::string line;
+            int timed = 0;
+            while (std::getline(file, line)) {
+                if (line.find(" took ") != std::string::npos && line.substr(line.length() - 3) == " us") {
+                    timed++;
+                }
+                if (line.find("decode") != std::string::npos || line.find("ignored") != std::string::npos) {
+                    return false;
+                }
+            }
+            file.close();
+
+            // Le fichier .log contient 4 logs de durée ('took ... us'), aucun des spans de trace seule.
+            if (timed != 4) {
+                return false;
+            }
+
+            std::ifstream trace("logger.trace.json");
+            if (!trace.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            while (std::getline(trace, line)) {
+                lines.push_back(line);
+            }
+            trace.close();
+
+            // Le fichier de trace est un tableau JSON qui commence par le nom du processus et contient 6 événements complets.
+            std::string head = "[{\"name\":\"process_name\",\"ph\":\"M\"";
+            if (lines.size() != 8 || lines[0].compare(0, head.length(), head) != 0 || lines[7] != "]") {
+                return false;
+            }
+            int nested = 0;
+            int traceOnly = 0;
+            std::vector<std::string> tids;
+            for (size_t i = 1; i < 7; i++) {
+                if (lines[i].compare(0, 1, "{") != 0 || lines[i].find("\"ph\":\"X\",\"ts\":") == std::string::npos) {
+                    return false;
+                }
+                // 4 événements sont imbriqués (profondeur 1), dont les 2 spans de trace seule.
+                if (lines[i].find("\"depth\":1") != std::string::npos) {
+                    nested++;
+                    if (lines[i].compare(0, 16, "{\"name\":\"decode\"") == 0) {
+                        traceOnly++;
+                    } else if (lines[i].compare(0, 15, "{\"name\":\"parse\"") != 0) {
+                        return false;
+                    }
+                }
+                size_t tid = lines[i].find("\"tid\":");
+                if (tid == std::string::npos) {
+                    return false;
+                }
+                std::string id = lines[i].substr(tid, lines[i].find(',', tid) - tid);
+                if (std::find(tids.begin(), tids.end(), id) == tids.end()) {
+                    tids.push_back(id);
+                }
+            }
+            if (nested != 4 || traceOnly != 2) {
+                return false;
+            }
+
+            // Les événements des 2 threads ont 2 identifiants de thread différents.
+            return tids.size() == 2;
+        },
+        []() {
+            rmDir("logs");
+            remove("logger.trace.json");
+        }
+};
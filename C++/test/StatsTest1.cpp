@@ -0,0 +1,101 @@
+#include "test.h"
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test statistiques 1 :
+ * Initialise le logger, log 3 fois en info, 2 fois en debug, 10 fois le même warning depuis un site limité
+ * et exit le logger.
+ *
+ * Conditions de réussite :
+ * - Le fichier .log contient 10 lignes de logs.
+ * - Les compteurs par type correspondent aux logs écrits.
+ * - 9 warnings sont comptés comme doublons.
+ * - Les octets écrits dans le fichier correspondent à sa taille.
+ * - Chaque ligne du fichier compte un flush.
+ */
+Test StatsTest1 = {
+        "StatsTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            LoggerStats before = Logger::global().stats();
+
+            Logger::init();
+
+            for (int i = 0; i < 3; i++) {
+                INFO_LOG(FILE_ONLY, "info ", i);
+            }
+            for (int i = 0; i < 2; i++) {
+                DEBUG_LOG(FILE_AND_CONSOLE, "debug ", i);
+            }
+            for (int i = 0; i < 10; i++) {
+                WARNING_LOG_LIMITED(FILE_ONLY, 1000, 100, "warning");
+            }
+
+            Logger::exit();
+
+            LoggerStats after = Logger::global().stats();
+
+            // ====================
+
+            // Le fichier .log contient 10 lignes de logs.
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            struct stat buffer{};
+            if (stat(("logs/" + fileName).c_str(), &buffer) != 0) {
+                return false;
+            }
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            int nbLines = 0;
+            std::string line;
+            while (std::getline(file, line)) {
+                nbLines++;
+            }
+            file.close();
+            if (nbLines != 10) {
+                return false;
+            }
+
+            // Les compteurs par type correspondent aux logs écrits.
+            if (after.messages[INFO] - before.messages[INFO] != 5 ||
+                after.messages[DEBUG] - before.messages[DEBUG] != 2 ||
+                after.messages[WARNING] - before.messages[WARNING] != 3) {
+                return false;
+            }
+
+            // 9 warnings sont comptés comme doublons.
+            if (after.suppressed - before.suppressed != 9) {
+                return false;
+            }
+
+            // Les octets écrits dans le fichier correspondent à sa taille.
+            if (after.fileBytes - before.fileBytes != (uint64_t) buffer.st_size) {
+                return false;
+            }
+
+            // Chaque ligne du fichier compte un flush.
+            if (after.flushes - before.flushes != 10 || after.consoleBytes == before.consoleBytes) {
+                return false;
+            }
+
+            return true;
+        },
+        []() {
+            rmDir("logs");
+        }
+};
@@ -0,0 +1,94 @@
+#include "test.h"
+#include <thread>
+
+#include "../logger/Logger.hpp"
+
+/**
+ * Test nom de thread 1 :
+ * Initialise un logger "thread" qui écrit l'identifiant et le nom du thread, log depuis le thread principal,
+ * depuis un thread nommé "worker-1" et depuis un thread sans nom, puis ferme le logger.
+ *
+ * Conditions de réussite :
+ * - Le fichier .log contient 6 lignes de logs.
+ * - Les 3 logs ont 3 identifiants de thread différents, composés de chiffres.
+ * - Le log du thread nommé contient son nom, les autres un nom non vide.
+ */
+Test ThreadNameTest1 = {
+        "ThreadNameTest1",
+        []() {
+            // Do nothing
+        },
+        []() {
+            Logger logger("thread");
+            logger.setFormats(CONSOLE_FORMAT, "[%i]\t[%I]\t%C", ADDITIONAL_FORMAT);
+            logger.open(FILE_ONLY);
+
+            INFO_LOG_TO(logger, FILE_ONLY, "main");
+            std::thread t1([&logger]() {
+                Logger::setThreadName("worker-1");
+                INFO_LOG_TO(logger, FILE_ONLY, "named");
+            });
+            t1.join();
+            std::thread t2([&logger]() {
+                INFO_LOG_TO(logger, FILE_ONLY, "unnamed");
+            });
+            t2.join();
+
+            logger.close();
+
+            // ====================
+
+            DIR *dir = opendir("logs");
+            if (dir == nullptr) {
+                return false;
+            }
+            struct dirent *ent;
+            std::string fileName;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+                    fileName = ent->d_name;
+                }
+            }
+            closedir(dir);
+            std::ifstream file("logs/" + fileName);
+            if (!file.is_open()) {
+                return false;
+            }
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(file, line)) {
+                lines.push_back(line);
+            }
+            file.close();
+
+            // Le fichier .log contient 6 lignes de logs.
+            if (lines.size() != 6) {
+                return false;
+            }
+
+            // Les 3 logs ont 3 identifiants de thread différents, composés de chiffres.
+            std::vector<std::string> ids;
+            std::vector<std::string> names;
+            for (size_t i = 2; i < 5; i++) {
+                size_t end = lines[i].find("]\t[");
+                size_t nameEnd = lines[i].find("]\t", end + 3);
+                if (lines[i][0] != '[' || end == std::string::npos || nameEnd == std::string::npos) {
+                    return false;
+                }
+                std::string id = lines[i].substr(1, end - 1);
+                if (id.empty() || id.find_first_not_of("0123456789") != std::string::npos ||
+                    std::find(ids.begin(), ids.end(), id) != ids.end()) {
+                    return false;
+                }
+                ids.push_back(id);
+                names.push_back(lines[i].substr(end + 3, nameEnd - end - 3));
+            }
+
+            // Le log du thread nommé contient son nom, les autres un nom non vide.
+            return names[1] == "worker-1" && !names[0].empty() && !names[2].empty() &&
+                   lines[3].substr(lines[3].length() - 5) == "named";
+        },
+        []() {
+            rmDir("logs");
+        }
+};
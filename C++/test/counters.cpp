@@ -0,0 +1,86 @@
+#include "counters.h"
+
+#include <new>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+
+std::atomic<uint64_t> allocationCount(0);
+
+std::atomic<uint64_t> writeCount(0);
+
+std::atomic<uint64_t> syncCount(0);
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+void *operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+    free(p);
+}
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+#ifdef __linux__
+/*
+ * The executable's definitions take precedence over the libc ones, also for the calls made by libstdc++
+ * The real work is done by the raw system calls
+ */
+extern "C" {
+
+ssize_t write(int fd, const void *buf, size_t count) {
+    writeCount.fetch_add(1, std::memory_order_relaxed);
+    return syscall(SYS_write, fd, buf, count);
+}
+
+ssize_t writev(int fd, const struct iovec *iov, int iovcnt) {
+    writeCount.fetch_add(1, std::memory_order_relaxed);
+    return syscall(SYS_writev, fd, iov, iovcnt);
+}
+
+ssize_t pwrite(int fd, const void *buf, size_t count, off_t offset) {
+    writeCount.fetch_add(1, std::memory_order_relaxed);
+    return syscall(SYS_pwrite64, fd, buf, count, offset);
+}
+
+ssize_t pwrite64(int fd, const void *buf, size_t count, off64_t offset) {
+    writeCount.fetch_add(1, std::memory_order_relaxed);
+    return syscall(SYS_pwrite64, fd, buf, count, offset);
+}
+
+int fsync(int fd) {
+    syncCount.fetch_add(1, std::memory_order_relaxed);
+    return (int) syscall(SYS_fsync, fd);
+}
+
+int fdatasync(int fd) {
+    syncCount.fetch_add(1, std::memory_order_relaxed);
+    return (int) syscall(SYS_fdatasync, fd);
+}
+
+}
+#endif
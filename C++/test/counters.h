@@ -0,0 +1,25 @@
+#ifndef LOGGER_COUNTERS_H
+#define LOGGER_COUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+
+/*
+ * Counters of the instrumented tests
+ * The global operator new and the write/sync functions of the libc are replaced in counters.cpp
+ */
+
+/**
+ * Number of calls to operator new
+ */
+extern std::atomic<uint64_t> allocationCount;
+/**
+ * Number of write(), writev() and pwrite() calls
+ */
+extern std::atomic<uint64_t> writeCount;
+/**
+ * Number of fsync() and fdatasync() calls
+ */
+extern std::atomic<uint64_t> syncCount;
+
+#endif //LOGGER_COUNTERS_H
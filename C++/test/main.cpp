@@ -17,9 +17,69 @@ int main() {
     extern Test BasicTest1;
     extern Test ThreadTest1;
     extern Test ThreadTest2;
+    extern Test LimitTest1;
+    extern Test SamplingTest1;
+    extern Test FlightRecorderTest1;
+    extern Test FlightRecorderTest2;
+    extern Test DirectFileTest1;
+    extern Test DurabilityTest1;
+    extern Test BudgetTest1;
+    extern Test StatsTest1;
+    extern Test HistogramTest1;
+    extern Test LockTest1;
+    extern Test ClockTest1;
+    extern Test LocalTimeTest1;
+    extern Test InstanceTest1;
+    extern Test InstanceTest2;
+    extern Test ModuleTest1;
+    extern Test ConfigTest1;
+    extern Test ConfigTest2;
+    extern Test SiteTest1;
+    extern Test KvTest1;
+    extern Test SanitizeTest1;
+    extern Test MultilineTest1;
+    extern Test SpanTest1;
+    extern Test ContextTest1;
+    extern Test ThreadNameTest1;
+    extern Test ShardTest1;
+    extern Test ShardTest2;
+    extern Test ShardTest3;
+    extern Test IndexTest1;
+    extern Test QueryTest1;
+    extern Test GrepTest1;
     tests.push_back(BasicTest1);
     tests.push_back(ThreadTest1);
     tests.push_back(ThreadTest2);
+    tests.push_back(LimitTest1);
+    tests.push_back(SamplingTest1);
+    tests.push_back(FlightRecorderTest1);
+    tests.push_back(FlightRecorderTest2);
+    tests.push_back(DirectFileTest1);
+    tests.push_back(DurabilityTest1);
+    tests.push_back(BudgetTest1);
+    tests.push_back(StatsTest1);
+    tests.push_back(HistogramTest1);
+    tests.push_back(LockTest1);
+    tests.push_back(ClockTest1);
+    tests.push_back(LocalTimeTest1);
+    tests.push_back(InstanceTest1);
+    tests.push_back(InstanceTest2);
+    tests.push_back(ModuleTest1);
+    tests.push_back(ConfigTest1);
+    tests.push_back(ConfigTest2);
+    tests.push_back(SiteTest1);
+    tests.push_back(KvTest1);
+    tests.push_back(SanitizeTest1);
+    tests.push_back(MultilineTest1);
+    tests.push_back(SpanTest1);
+    tests.push_back(ContextTest1);
+    tests.push_back(ThreadNameTest1);
+    tests.push_back(ShardTest1);
+    tests.push_back(ShardTest2);
+    tests.push_back(ShardTest3);
+    tests.push_back(IndexTest1);
+    tests.push_back(QueryTest1);
+    tests.push_back(GrepTest1);
 
     // ====================
 
@@ -6,6 +6,8 @@
 #include <cstring>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <cstdio>
+#include <sys/wait.h>
 
 static int rmDir(const std::string &path) {
     DIR *d = opendir(path.c_str());
@@ -51,4 +53,27 @@ static int rmDir(const std::string &path) {
     return r;
 }
 
+#ifdef LOGGER_TOOLS_DIR
+/**
+ * Run a tool built next to the tests (LOGGER_TOOLS_DIR)
+ * @param command std::string Name of the tool followed by its arguments
+ * @param output std::string Standard output of the tool
+ * @return int Exit status of the tool, -1 if it cannot be run
+ */
+static inline int runTool(const std::string &command, std::string &output) {
+    output.clear();
+    FILE *pipe = popen((std::string(LOGGER_TOOLS_DIR) + "/" + command).c_str(), "r");
+    if (pipe == nullptr)
+        return -1;
+
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0)
+        output.append(buffer, n);
+    int status = pclose(pipe);
+
+    return status >= 0 && WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+#endif
+
 #endif //LOGGER_UTILS_H
@@ -0,0 +1,272 @@
+#ifndef LOGGER_FORMAT_H
+#define LOGGER_FORMAT_H
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+ * Lines of a log file written with a format, read by logger_grep and logger_query
+ */
+
+static const char *findScalar(const char *data, size_t length, const char *pattern, size_t size) {
+    return (const char *) memmem(data, length, pattern, size);
+}
+
+#ifdef __SSE2__
+/*
+ * Compare the first and the last byte of the pattern at 16 positions at once,
+ * the whole pattern is only compared where both match
+ */
+static const char *findSse2(const char *data, size_t length, const char *pattern, size_t size) {
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last = _mm_set1_epi8(pattern[size - 1]);
+
+    size_t i = 0;
+    for (; i + size - 1 + 16 <= length; i += 16) {
+        __m128i start = _mm_loadu_si128((const __m128i *) (data + i));
+        __m128i end = _mm_loadu_si128((const __m128i *) (data + i + size - 1));
+        auto mask = (unsigned) _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(start, first),
+                                                               _mm_cmpeq_epi8(end, last)));
+        while (mask != 0) {
+            unsigned bit = (unsigned) __builtin_ctz(mask);
+            if (size <= 2 || memcmp(data + i + bit + 1, pattern + 1, size - 2) == 0)
+                return data + i + bit;
+            mask &= mask - 1;
+        }
+    }
+
+    return findScalar(data + i, length - i, pattern, size);
+}
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TOOLS_HAS_AVX2
+
+__attribute__((target("avx2")))
+static const char *findAvx2(const char *data, size_t length, const char *pattern, size_t size) {
+    const __m256i first = _mm256_set1_epi8(pattern[0]);
+    const __m256i last = _mm256_set1_epi8(pattern[size - 1]);
+
+    size_t i = 0;
+    for (; i + size - 1 + 32 <= length; i += 32) {
+        __m256i start = _mm256_loadu_si256((const __m256i *) (data + i));
+        __m256i end = _mm256_loadu_si256((const __m256i *) (data + i + size - 1));
+        auto mask = (unsigned) _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(start, first),
+                                                                     _mm256_cmpeq_epi8(end, last)));
+        while (mask != 0) {
+            unsigned bit = (unsigned) __builtin_ctz(mask);
+            if (size <= 2 || memcmp(data + i + bit + 1, pattern + 1, size - 2) == 0)
+                return data + i + bit;
+            mask &= mask - 1;
+        }
+    }
+
+    return findSse2(data + i, length - i, pattern, size);
+}
+#endif
+
+/**
+ * First occurrence of the pattern, 32 (AVX2) or 16 (SSE2) positions at once when the CPU has them
+ * @param data const char*
+ * @param length size_t
+ * @param pattern std::string Not empty
+ * @return const char* nullptr if not found
+ */
+static const char *find(const char *data, size_t length, const std::string &pattern) {
+    size_t size = pattern.length();
+    if (size > length)
+        return nullptr;
+    if (size == 1)
+        return (const char *) memchr(data, pattern[0], length);
+#ifdef TOOLS_HAS_AVX2
+    static const bool avx2 = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    if (avx2)
+        return findAvx2(data, length, pattern.data(), size);
+#endif
+#ifdef __SSE2__
+    return findSse2(data, length, pattern.data(), size);
+#else
+    return findScalar(data, length, pattern.data(), size);
+#endif
+}
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+/**
+ * A literal text or a token of the format
+ */
+struct Part {
+    bool literal;
+    char token;
+    std::string text;
+};
+
+/**
+ * Fields of a line used by the filters
+ */
+struct Line {
+    const char *type = nullptr;
+    size_t typeLength = 0;
+    const char *trace = nullptr;
+    size_t traceLength = 0;
+    /**
+     * Nanoseconds since midnight, -1 if the format has no time
+     */
+    int64_t time = -1;
+};
+
+/**
+ * Cut the format in literals and tokens
+ * @param format std::string
+ * @return std::vector<Part>
+ */
+static std::vector<Part> compile(const std::string &format) {
+    std::vector<Part> parts;
+    for (size_t i = 0; i < format.length(); i++) {
+        if (format[i] == '%' && i + 1 < format.length()) {
+            char token = format[++i];
+            // %X{key} is one token
+            if (token == 'X' && i + 1 < format.length() && format[i + 1] == '{') {
+                size_t end = format.find('}', i);
+                i = end == std::string::npos ? format.length() : end;
+            }
+            parts.push_back({false, token, ""});
+        } else if (!parts.empty() && parts.back().literal)
+            parts.back().text += format[i];
+        else
+            parts.push_back({true, 0, std::string(1, format[i])});
+    }
+
+    return parts;
+}
+
+/**
+ * Read a number, the mapping is not terminated by '\0' so the C functions are not used
+ * @param p const char*
+ * @param end const char*
+ * @return int64_t
+ */
+static int64_t number(const char *&p, const char *end) {
+    int64_t res = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+        res = res * 10 + (*p++ - '0');
+
+    return res;
+}
+
+/**
+ * Read the fields of a line
+ * @param p const char* Start of the line
+ * @param end const char* End of the line, without '\n'
+ * @param parts std::vector<Part>
+ * @param line Line
+ * @return bool False if the line does not match the format
+ */
+static bool parse(const char *p, const char *end, const std::vector<Part> &parts, Line &line) {
+    int64_t hour = -1, minute = 0, second = 0, nano = 0;
+
+    for (size_t k = 0; k < parts.size(); k++) {
+        const Part &part = parts[k];
+        if (part.literal) {
+            if ((size_t) (end - p) < part.text.length() || memcmp(p, part.text.data(), part.text.length()) != 0)
+                return false;
+            p += part.text.length();
+            continue;
+        }
+
+        // The tokens of known characters stop at the first other character, the others at the next literal
+        const char *q = p;
+        switch (part.token) {
+            case 'n':
+            case 'i':
+            case 'Y':
+            case 'M':
+            case 'D':
+            case 'H':
+            case 'm':
+            case 'S':
+            case 'N':
+                while (q < end && *q >= '0' && *q <= '9')
+                    q++;
+                break;
+            case 'h':
+                while (q < end && ((*q >= '0' && *q <= '9') || *q == ':'))
+                    q++;
+                break;
+            case 'd':
+                while (q < end && ((*q >= '0' && *q <= '9') || *q == '-' || *q == '@'))
+                    q++;
+                break;
+            case 't':
+                while (q < end && *q >= 'A' && *q <= 'Z')
+                    q++;
+                break;
+            default:
+                if (k + 1 < parts.size() && parts[k + 1].literal) {
+                    q = find(p, (size_t) (end - p), parts[k + 1].text);
+                    if (q == nullptr)
+                        return false;
+                } else
+                    q = end;
+                break;
+        }
+
+        switch (part.token) {
+            case 't':
+                line.type = p;
+                line.typeLength = (size_t) (q - p);
+                break;
+            case 'T':
+                line.trace = p;
+                line.traceLength = (size_t) (q - p);
+                break;
+            case 'h': {
+                // H:m:S:N
+                const char *r = p;
+                int64_t values[4];
+                for (int v = 0; v < 4; v++) {
+                    if (v > 0 && (r >= q || *r++ != ':'))
+                        return false;
+                    values[v] = number(r, q);
+                }
+                hour = values[0];
+                minute = values[1];
+                second = values[2];
+                nano = values[3];
+                break;
+            }
+            case 'H':
+                hour = number(p, q);
+                break;
+            case 'm':
+                minute = number(p, q);
+                break;
+            case 'S':
+                second = number(p, q);
+                break;
+            case 'N':
+                nano = number(p, q);
+                break;
+            default:
+                break;
+        }
+        p = q;
+    }
+
+    if (hour >= 0)
+        line.time = ((hour * 60 + minute) * 60 + second) * 1000000000 + nano;
+
+    return true;
+}
+
+
+#endif //LOGGER_FORMAT_H
@@ -0,0 +1,344 @@
+#include <vector>
+#include <string>
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstring>
+#include <cstdlib>
+#include "mapping.h"
+#include "format.h"
+
+#include "../logger/Logger.hpp"
+
+using namespace std;
+
+/*
+ * Search log files written with a format
+ *
+ * Usage : logger_grep [-f format] [-e pattern] [-l types] [-T trace] [-a from] [-b to] [-c] [-j threads] [-p bytes]
+ *                    file...
+ *
+ * -f format   Format of the files, as given to setFormats(), FILE_FORMAT by default
+ * -e pattern  Lines containing the pattern
+ * -l types    Logs of these types (%t), separated by commas : INFO,ERROR
+ * -T trace    Logs of this trace (%T)
+ * -a from     Logs at or after this time of day (%h or %H %m %S), HH:MM[:SS]
+ * -b to       Logs before this time of day
+ * -c          Only write the number of lines found
+ * -j threads  Number of threads, the number of cores by default
+ * -p bytes    Size of the pieces searched by a thread, 8 MB by default
+ *
+ * The files are mapped in memory and cut in pieces at line boundaries, searched in parallel and
+ * written in order. A line which does not match the format belongs to the log before it.
+ * Without type, trace or time, the pattern is searched in the whole piece instead of line by line.
+ */
+
+/**
+ * Default size of a piece of file searched by a thread
+ */
+static const size_t PIECE = 8 << 20;
+
+// _.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-._.-.
+
+/**
+ * Options of the search
+ */
+struct Search {
+    vector<Part> parts;
+    string pattern;
+    vector<string> types;
+    string trace;
+    bool traced = false;
+    int64_t from = -1;
+    int64_t to = -1;
+    bool count = false;
+    /**
+     * 'file:' in front of each line when there are several files
+     */
+    string prefix;
+
+    bool filtered() const {
+        return !types.empty() || traced || from >= 0 || to >= 0;
+    }
+
+    /**
+     * If a log passes the type, trace and time filters
+     * @param line Line
+     * @return bool
+     */
+    bool accepts(const Line &line) const {
+        if (!types.empty()) {
+            bool found = false;
+            for (const auto &type: types)
+                if (type.length() == line.typeLength && memcmp(type.data(), line.type, line.typeLength) == 0)
+                    found = true;
+            if (!found)
+                return false;
+        }
+        if (traced && (trace.length() != line.traceLength || memcmp(trace.data(), line.trace, line.traceLength) != 0))
+            return false;
+        if (from >= 0 && (line.time < 0 || line.time < from))
+            return false;
+        if (to >= 0 && (line.time < 0 || line.time >= to))
+            return false;
+
+        return true;
+    }
+};
+
+/**
+ * Lines found in a piece
+ */
+struct Result {
+    string text;
+    uint64_t lines = 0;
+};
+
+static void emit(const Search &search, Result &result, const char *start, const char *end) {
+    result.lines++;
+    if (search.count)
+        return;
+    result.text += search.prefix;
+    result.text.append(start, (size_t) (end - start));
+    if (end == start || end[-1] != '\n')
+        result.text += '\n';
+}
+
+/**
+ * Search a piece of file
+ * @param search Search
+ * @param file const char* Start of the file, to find the log of a piece's first line
+ * @param begin const char* Start of the piece, at a line boundary
+ * @param end const char* End of the piece, at a line boundary
+ * @param result Result
+ */
+static void scan(const Search &search, const char *file, const char *begin, const char *end, Result &result) {
+    if (!search.filtered() && !search.pattern.empty()) {
+        // Only the lines around an occurrence of the pattern are looked at
+        const char *p = begin;
+        while (p < end) {
+            const char *hit = find(p, (size_t) (end - p), search.pattern);
+            if (hit == nullptr)
+                break;
+            const char *start = hit;
+            while (start > begin && start[-1] != '\n')
+                start--;
+            auto *newline = (const char *) memchr(hit, '\n', (size_t) (end - hit));
+            const char *stop = newline == nullptr ? end : newline + 1;
+            emit(search, result, start, stop);
+            p = stop;
+        }
+        return;
+    }
+
+    // The first lines of the piece may belong to a log of the previous piece
+    bool accepted = !search.filtered();
+    Line line;
+    const char *start = begin;
+    while (search.filtered() && start > file) {
+        const char *previous = start - 1;
+        while (previous > file && previous[-1] != '\n')
+            previous--;
+        line = Line();
+        if (parse(previous, start - 1, search.parts, line)) {
+            accepted = search.accepts(line);
+            break;
+        }
+        start = previous;
+    }
+
+    const char *p = begin;
+    while (p < end) {
+        auto *newline = (const char *) memchr(p, '\n', (size_t) (end - p));
+        const char *stop = newline == nullptr ? end : newline;
+        line = Line();
+        if (search.filtered() && parse(p, stop, search.parts, line))
+            accepted = search.accepts(line);
+        if (accepted && (search.pattern.empty() || find(p, (size_t) (stop - p), search.pattern) != nullptr))
+            emit(search, result, p, newline == nullptr ? end : newline + 1);
+        p = newline == nullptr ? end : newline + 1;
+    }
+}
+
+/**
+ * Search a file with several threads, the results are written in the order of the pieces
+ * @param search Search
+ * @param data const char*
+ * @param length size_t
+ * @param threads unsigned
+ * @param piece size_t Size of a piece, before it is extended to the end of its last line
+ * @return uint64_t Number of lines found
+ */
+static uint64_t searchFile(const Search &search, const char *data, size_t length, unsigned threads, size_t piece) {
+    // Pieces end after a '\n'
+    vector<size_t> bounds = {0};
+    while (bounds.back() < length) {
+        size_t next = bounds.back() + piece;
+        if (next >= length)
+            next = length;
+        else {
+            auto *newline = (const char *) memchr(data + next, '\n', length - next);
+            next = newline == nullptr ? length : (size_t) (newline - data) + 1;
+        }
+        bounds.push_back(next);
+    }
+    size_t pieces = bounds.size() - 1;
+
+    vector<Result> results(pieces);
+    vector<char> done(pieces, 0);
+    size_t written = 0;
+    atomic<size_t> next(0);
+    mutex lock;
+    condition_variable changed;
+
+    // A thread does not take a piece too far ahead of the writes, so the memory stays bounded
+    auto work = [&]() {
+        for (;;) {
+            size_t taken = next.fetch_add(1);
+            if (taken >= pieces)
+                return;
+            {
+                unique_lock<mutex> guard(lock);
+                changed.wait(guard, [&]() { return taken < written + 2 * threads; });
+            }
+            scan(search, data, data + bounds[taken], data + bounds[taken + 1], results[taken]);
+            {
+                lock_guard<mutex> guard(lock);
+                done[taken] = 1;
+            }
+            changed.notify_all();
+        }
+    };
+
+    vector<thread> workers;
+    for (unsigned t = 0; t < threads; t++)
+        workers.emplace_back(work);
+
+    uint64_t lines = 0;
+    while (written < pieces) {
+        Result result;
+        {
+            unique_lock<mutex> guard(lock);
+            changed.wait(guard, [&]() { return done[written] != 0; });
+            result.text.swap(results[written].text);
+            result.lines = results[written].lines;
+            written++;
+        }
+        changed.notify_all();
+
+        lines += result.lines;
+        size_t offset = 0;
+        while (offset < result.text.length()) {
+            ssize_t n = write(STDOUT_FILENO, result.text.data() + offset, result.text.length() - offset);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                break;
+            offset += (size_t) n;
+        }
+    }
+
+    for (auto &worker: workers)
+        worker.join();
+
+    return lines;
+}
+
+/**
+ * Parse a time of day
+ * @param text const char* HH:MM[:SS]
+ * @param res int64_t Nanoseconds since midnight
+ * @return bool
+ */
+static bool parseTime(const char *text, int64_t &res) {
+    int hour, minute, second = 0;
+    if (sscanf(text, "%d:%d:%d", &hour, &minute, &second) < 2)
+        return false;
+    res = (((int64_t) hour * 60 + minute) * 60 + second) * 1000000000;
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    Search search;
+    string format = FILE_FORMAT;
+    unsigned threads = thread::hardware_concurrency();
+    size_t piece = PIECE;
+    vector<string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool value = i + 1 < argc;
+        if (arg == "-f" && value)
+            format = argv[++i];
+        else if (arg == "-e" && value)
+            search.pattern = argv[++i];
+        else if (arg == "-l" && value) {
+            string types = argv[++i];
+            size_t start = 0;
+            while (start <= types.length()) {
+                size_t comma = types.find(',', start);
+                if (comma == string::npos)
+                    comma = types.length();
+                if (comma > start)
+                    search.types.push_back(types.substr(start, comma - start));
+                start = comma + 1;
+            }
+        } else if (arg == "-T" && value) {
+            search.trace = argv[++i];
+            search.traced = true;
+        } else if (arg == "-a" && value) {
+            if (!parseTime(argv[++i], search.from)) {
+                cerr << "Times are HH:MM[:SS]" << endl;
+                return 2;
+            }
+        } else if (arg == "-b" && value) {
+            if (!parseTime(argv[++i], search.to)) {
+                cerr << "Times are HH:MM[:SS]" << endl;
+                return 2;
+            }
+        } else if (arg == "-c")
+            search.count = true;
+        else if (arg == "-j" && value)
+            threads = (unsigned) atoi(argv[++i]);
+        else if (arg == "-p" && value)
+            piece = (size_t) strtoull(argv[++i], nullptr, 10);
+        else
+            paths.push_back(arg);
+    }
+    if (paths.empty() || (search.pattern.empty() && !search.filtered() && !search.count)) {
+        cerr << "Usage : logger_grep [-f format] [-e pattern] [-l types] [-T trace] [-a from] [-b to] [-c] "
+                "[-j threads] [-p bytes] file..." << endl;
+        return 2;
+    }
+    if (threads == 0)
+        threads = 1;
+    if (piece == 0)
+        piece = PIECE;
+    search.parts = compile(format);
+
+    uint64_t total = 0;
+    int status = 0;
+    for (const auto &path: paths) {
+        Mapping file;
+        if (!file.open(path)) {
+            cerr << "Cannot read " << path << endl;
+            status = 1;
+            continue;
+        }
+        if (paths.size() > 1)
+            search.prefix = path + ":";
+        file.sequential(0, file.length);
+
+        uint64_t lines = file.length == 0 ? 0 : searchFile(search, file.data, file.length, threads, piece);
+        if (search.count && paths.size() > 1)
+            cout << path << ":" << lines << endl;
+        total += lines;
+    }
+    if (search.count && paths.size() == 1)
+        cout << total << endl;
+
+    return status != 0 ? status : total > 0 ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+#ifndef LOGGER_MAPPING_H
+#define LOGGER_MAPPING_H
+
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * A file mapped in memory, read only
+ */
+struct Mapping {
+    const char *data = nullptr;
+    size_t length = 0;
+
+    Mapping() = default;
+
+    Mapping(const Mapping &) = delete;
+
+    Mapping &operator=(const Mapping &) = delete;
+
+    /**
+     * @param path std::string
+     * @return bool False if the file cannot be mapped
+     */
+    bool open(const std::string &path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info{};
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        length = (size_t) info.st_size;
+        if (length > 0) {
+            void *address = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+            if (address == MAP_FAILED) {
+                ::close(fd);
+                return false;
+            }
+            data = (const char *) address;
+        }
+        ::close(fd);
+
+        return true;
+    }
+
+    /**
+     * Tell the kernel a range is read in order
+     * @param offset size_t
+     * @param size size_t
+     */
+    void sequential(size_t offset, size_t size) const {
+        auto page = (size_t) sysconf(_SC_PAGESIZE);
+        size_t start = offset / page * page;
+        if (data != nullptr && size > 0)
+            madvise((void *) (data + start), size + offset - start, MADV_SEQUENTIAL);
+    }
+
+    ~Mapping() {
+        if (data != nullptr)
+            munmap((void *) data, length);
+    }
+};
+
+#endif //LOGGER_MAPPING_H
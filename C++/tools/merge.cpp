@@ -0,0 +1,59 @@
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+
+#include "../logger/Logger.hpp"
+
+using namespace std;
+
+/*
+ * Merge of the files written by the SHARDED_FILE mode
+ *
+ * Usage : logger_merge [-o output] [-w window_ms] shard...
+ *
+ * Writes the logs of all the shards ordered by their number, without the number and the time
+ * added by the shards, on the standard output or in the output file.
+ * The logs written during the reorder window (1000 ms by default) are in memory.
+ */
+
+int main(int argc, char **argv) {
+    // cout is not flushed to stdio after each write
+    ios::sync_with_stdio(false);
+
+    string output;
+    int64_t windowMs = 1000;
+    vector<string> paths;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+            windowMs = atoll(argv[++i]);
+        else
+            paths.push_back(argv[i]);
+    }
+    if (paths.empty() || windowMs < 0) {
+        cerr << "Usage : logger_merge [-o output] [-w window_ms] shard..." << endl;
+        return 2;
+    }
+
+    ofstream file;
+    if (!output.empty()) {
+        file.open(output, ios::out | ios::trunc);
+        if (!file.is_open()) {
+            cerr << "Cannot create " << output << endl;
+            return 1;
+        }
+    }
+
+    ostream &out = output.empty() ? cout : file;
+
+    if (!Logger::mergeShards(paths, out, windowMs * 1000000)) {
+        cerr << "Cannot read the shards" << endl;
+        return 1;
+    }
+    out.flush();
+
+    return 0;
+}
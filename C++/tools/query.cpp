@@ -0,0 +1,193 @@
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include "mapping.h"
+#include "format.h"
+
+#include "../logger/Logger.hpp"
+
+using namespace std;
+
+/*
+ * Read a range of time of a log file with its time index (see Logger::setTimeIndex())
+ *
+ * Usage : logger_query [-i index] [-f format] log from to
+ *
+ * from and to are local times, 'YYYY-MM-DD HH:MM[:SS]' (or with a 'T') or 'HH:MM[:SS]' on the day of
+ * the first entry of the index. Writes the logs from 'from' to before 'to' on the standard output.
+ * The entries of the index around them give the range, at most one interval of the index wider on each side,
+ * then the lines at both ends are read with the format (FILE_FORMAT by default, as logger_grep) to cut it
+ * at the first log at or after 'from' and at the first log at or after 'to'.
+ * With a format without the time of day (%h or %H), the range stays widened to the entries.
+ * The index and the log are mapped in memory, only the pages of the range are read.
+ */
+
+/**
+ * Parse a local time
+ * @param text const char*
+ * @param reference int64_t Nanoseconds since the epoch, gives the day when the text has none
+ * @param res int64_t Nanoseconds since the epoch
+ * @return bool False if the text is not a time
+ */
+static bool parseTime(const char *text, int64_t reference, int64_t &res) {
+    time_t seconds = (time_t) (reference / 1000000000);
+    struct tm t{};
+    localtime_r(&seconds, &t);
+    int year, month, day, hour, minute, second = 0;
+    char separator;
+
+    if (sscanf(text, "%d-%d-%d%c%d:%d:%d", &year, &month, &day, &separator, &hour, &minute, &second) >= 6 &&
+        (separator == ' ' || separator == 'T')) {
+        t.tm_year = year - 1900;
+        t.tm_mon = month - 1;
+        t.tm_mday = day;
+    } else if (sscanf(text, "%d:%d:%d", &hour, &minute, &second) < 2)
+        return false;
+
+    t.tm_hour = hour;
+    t.tm_min = minute;
+    t.tm_sec = second;
+    t.tm_isdst = -1;
+    res = (int64_t) mktime(&t) * 1000000000;
+
+    return true;
+}
+
+/**
+ * Time of a log from its time of day, on the day of a nearby time
+ * @param timeOfDay int64_t Nanoseconds since midnight
+ * @param reference int64_t Nanoseconds since the epoch, a time of the index near the log
+ * @return int64_t Nanoseconds since the epoch
+ */
+static int64_t absoluteTime(int64_t timeOfDay, int64_t reference) {
+    time_t seconds = (time_t) (reference / 1000000000);
+    struct tm day{};
+    localtime_r(&seconds, &day);
+
+    // The log can be on the day before or after the reference around midnight
+    int64_t res = 0;
+    for (int shift: {0, -1, 1}) {
+        struct tm t = day;
+        t.tm_mday += shift;
+        t.tm_hour = (int) (timeOfDay / 3600000000000LL);
+        t.tm_min = (int) (timeOfDay / 60000000000LL % 60);
+        t.tm_sec = (int) (timeOfDay / 1000000000 % 60);
+        t.tm_isdst = -1;
+        res = (int64_t) mktime(&t) * 1000000000 + timeOfDay % 1000000000;
+        if (res - reference <= 43200000000000LL && reference - res <= 43200000000000LL)
+            break;
+    }
+
+    return res;
+}
+
+/**
+ * Find the first log at or after a time, a line which does not match the format belongs to the log before it
+ * @param log Mapping
+ * @param p size_t Offset of a line
+ * @param stop size_t End of the search
+ * @param parts std::vector<Part> The format
+ * @param reference int64_t A time of the index near the lines
+ * @param time int64_t Nanoseconds since the epoch
+ * @return size_t Offset of the log's line, stop if none
+ */
+static size_t findTime(const Mapping &log, size_t p, size_t stop, const vector<Part> &parts, int64_t reference,
+                       int64_t time) {
+    while (p < stop) {
+        const char *line = log.data + p;
+        const char *newline = (const char *) memchr(line, '\n', stop - p);
+        const char *end = newline == nullptr ? log.data + stop : newline;
+        Line fields;
+        if (parse(line, end, parts, fields) && fields.time >= 0 && absoluteTime(fields.time, reference) >= time)
+            return p;
+        p = (size_t) (end - log.data) + 1;
+    }
+
+    return stop;
+}
+
+int main(int argc, char **argv) {
+    string indexPath;
+    string format = FILE_FORMAT;
+    int i = 1;
+    while (i + 1 < argc && (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "-f") == 0)) {
+        if (argv[i][1] == 'i')
+            indexPath = argv[i + 1];
+        else
+            format = argv[i + 1];
+        i += 2;
+    }
+    if (argc - i != 3) {
+        cerr << "Usage : logger_query [-i index] [-f format] log from to" << endl;
+        return 2;
+    }
+    string logPath = argv[i];
+    if (indexPath.empty())
+        indexPath = logPath + ".idx";
+
+    Mapping index;
+    if (!index.open(indexPath) || index.length < sizeof(LOGGER_INDEX_MAGIC) ||
+        memcmp(index.data, LOGGER_INDEX_MAGIC, sizeof(LOGGER_INDEX_MAGIC)) != 0) {
+        cerr << "Cannot read the index " << indexPath << endl;
+        return 1;
+    }
+    // The entries follow the 8 bytes of the magic, so they are aligned in the mapping
+    auto *first = (const LoggerIndexEntry *) (index.data + sizeof(LOGGER_INDEX_MAGIC));
+    auto *last = first + (index.length - sizeof(LOGGER_INDEX_MAGIC)) / sizeof(LoggerIndexEntry);
+
+    int64_t from, to;
+    int64_t reference = first != last ? first->time : 0;
+    if (!parseTime(argv[i + 1], reference, from) || !parseTime(argv[i + 2], reference, to)) {
+        cerr << "Times are 'YYYY-MM-DD HH:MM[:SS]' or 'HH:MM[:SS]'" << endl;
+        return 2;
+    }
+
+    Mapping log;
+    if (!log.open(logPath)) {
+        cerr << "Cannot read the log " << logPath << endl;
+        return 1;
+    }
+
+    // From the last entry at or before 'from' to the first entry at or after 'to'
+    auto begin = upper_bound(first, last, from, [](int64_t time, const LoggerIndexEntry &entry) {
+        return time < entry.time;
+    });
+    auto end = lower_bound(begin, last, to, [](const LoggerIndexEntry &entry, int64_t time) {
+        return entry.time < time;
+    });
+    size_t start = begin == first ? 0 : (size_t) (begin - 1)->offset;
+    size_t stop = end == last ? log.length : (size_t) end->offset;
+    if (stop > log.length)
+        stop = log.length;
+    if (start >= stop)
+        return 0;
+
+    // Only the lines before the first entry in the range and after the last one are parsed
+    vector<Part> parts = compile(format);
+    bool timed = false;
+    for (const auto &part: parts)
+        timed = timed || (!part.literal && (part.token == 'h' || part.token == 'H'));
+    if (timed) {
+        int64_t before = begin == first ? reference : (begin - 1)->time;
+        start = findTime(log, start, stop, parts, before, from);
+        size_t tail = end == begin ? start : max(start, (size_t) (end - 1)->offset);
+        int64_t after = end == begin ? before : (end - 1)->time;
+        stop = findTime(log, tail, stop, parts, after, to);
+        if (start >= stop)
+            return 0;
+    }
+
+    log.sequential(start, stop - start);
+    size_t written = start;
+    while (written < stop) {
+        ssize_t n = write(STDOUT_FILENO, log.data + written, stop - written);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return 1;
+        written += (size_t) n;
+    }
+
+    return 0;
+}